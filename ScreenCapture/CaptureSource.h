@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include "RegionCache.h"
+
+// Pixels of one capture: top-down BGRA rows, stride bytes apart. Owned by
+// the source and valid until its next capture.
+struct CaptureFrame
+{
+    const uint8_t* pixels;
+    int width;
+    int height;
+    int stride;
+};
+
+// Where region captures come from: the screen in the application, an image
+// file in the benchmarks. Implementations reuse their buffer between
+// captures, so repeating the same region allocates nothing.
+class CaptureSource
+{
+public:
+    virtual ~CaptureSource() = default;
+
+    virtual bool capture(const Region& region, CaptureFrame& frame) = 0;
+};
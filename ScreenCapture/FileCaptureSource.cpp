@@ -0,0 +1,63 @@
+// FileCaptureSource.cpp
+#include "FileCaptureSource.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+FileCaptureSource::FileCaptureSource(const std::string& path)
+    : image(nullptr)
+{
+    PIX* decoded = pixRead(path.c_str());
+    if (!decoded)
+        throw std::runtime_error("Failed to read image '" + path + "'.");
+
+    image = pixConvertTo32(decoded);
+    pixDestroy(&decoded);
+    if (!image)
+        throw std::runtime_error("Failed to convert image '" + path + "'.");
+}
+
+FileCaptureSource::~FileCaptureSource()
+{
+    pixDestroy(&image);
+}
+
+bool FileCaptureSource::capture(const Region& region, CaptureFrame& frame)
+{
+    int left = std::max(region.x, 0);
+    int top = std::max(region.y, 0);
+    int right = std::min(region.x + region.width, getWidth());
+    int bottom = std::min(region.y + region.height, getHeight());
+    if (right <= left || bottom <= top)
+        return false;
+
+    int width = right - left;
+    int height = bottom - top;
+    size_t needed = static_cast<size_t>(width) * height;
+    if (buffer.size() < needed)
+        buffer.resize(needed);
+
+    // Leptonica stores 0xRRGGBBAA, a little-endian BGRA pixel reads as 0xAARRGGBB
+    const l_uint32* data = pixGetData(image);
+    int wpl = pixGetWpl(image);
+    for (int y = 0; y < height; ++y)
+    {
+        const l_uint32* srcRow = data + static_cast<size_t>(top + y) * wpl + left;
+        uint32_t* dstRow = buffer.data() + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x)
+            dstRow[x] = 0xFF000000u | (srcRow[x] >> 8);
+    }
+
+    frame = { reinterpret_cast<const uint8_t*>(buffer.data()), width, height, width * 4 };
+    return true;
+}
+
+int FileCaptureSource::getWidth() const
+{
+    return pixGetWidth(image);
+}
+
+int FileCaptureSource::getHeight() const
+{
+    return pixGetHeight(image);
+}
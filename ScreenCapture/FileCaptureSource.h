@@ -0,0 +1,32 @@
+#pragma once
+
+#include <leptonica/allheaders.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CaptureSource.h"
+
+// Captures regions of an image file instead of the screen, so the capture
+// and recognition path can be timed without a desktop. The image is decoded
+// once; each capture copies the region into a reusable BGRA buffer, the same
+// layout GdiCaptureSource produces.
+class FileCaptureSource : public CaptureSource
+{
+public:
+    // Throws std::runtime_error if the image cannot be read
+    explicit FileCaptureSource(const std::string& path);
+    ~FileCaptureSource() override;
+
+    FileCaptureSource(const FileCaptureSource&) = delete;
+    FileCaptureSource& operator=(const FileCaptureSource&) = delete;
+
+    // Region in image coordinates, clipped to the image
+    bool capture(const Region& region, CaptureFrame& frame) override;
+
+    int getWidth() const;
+    int getHeight() const;
+
+private:
+    PIX* image;     // 32bpp
+    std::vector<uint32_t> buffer;
+};
@@ -0,0 +1,79 @@
+// GdiCaptureSource.cpp
+#include "GdiCaptureSource.h"
+
+GdiCaptureSource::GdiCaptureSource()
+    : memoryDC(NULL), dib(NULL), oldBitmap(NULL), pixels(nullptr),
+      capacityWidth(0), capacityHeight(0)
+{
+}
+
+GdiCaptureSource::~GdiCaptureSource()
+{
+    release();
+}
+
+bool GdiCaptureSource::capture(const Region& region, CaptureFrame& frame)
+{
+    if (region.isEmpty())
+        return false;
+    if (!reserve(region.width, region.height))
+        return false;
+
+    HDC hScreenDC = GetDC(NULL);
+    BOOL copied = BitBlt(memoryDC, 0, 0, region.width, region.height, hScreenDC, region.x, region.y, SRCCOPY);
+    ReleaseDC(NULL, hScreenDC);
+
+    // Make sure GDI finished writing before the pixels are read directly
+    GdiFlush();
+
+    frame = { pixels, region.width, region.height, capacityWidth * 4 };
+    return copied != FALSE;
+}
+
+bool GdiCaptureSource::reserve(int newWidth, int newHeight)
+{
+    if (dib && newWidth <= capacityWidth && newHeight <= capacityHeight)
+        return true;
+
+    int allocWidth = max(newWidth, capacityWidth);
+    int allocHeight = max(newHeight, capacityHeight);
+    release();
+
+    BITMAPINFO bi = { 0 };
+    bi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bi.bmiHeader.biWidth = allocWidth;
+    bi.bmiHeader.biHeight = -allocHeight;     // Top-down rows
+    bi.bmiHeader.biPlanes = 1;
+    bi.bmiHeader.biBitCount = 32;
+    bi.bmiHeader.biCompression = BI_RGB;
+
+    memoryDC = CreateCompatibleDC(NULL);
+    dib = CreateDIBSection(memoryDC, &bi, DIB_RGB_COLORS, reinterpret_cast<void**>(&pixels), NULL, 0);
+    if (!memoryDC || !dib)
+    {
+        release();
+        return false;
+    }
+    oldBitmap = (HBITMAP)SelectObject(memoryDC, dib);
+
+    capacityWidth = allocWidth;
+    capacityHeight = allocHeight;
+    return true;
+}
+
+void GdiCaptureSource::release()
+{
+    if (memoryDC && oldBitmap)
+        SelectObject(memoryDC, oldBitmap);
+    if (dib)
+        DeleteObject(dib);
+    if (memoryDC)
+        DeleteDC(memoryDC);
+
+    memoryDC = NULL;
+    dib = NULL;
+    oldBitmap = NULL;
+    pixels = nullptr;
+    capacityWidth = 0;
+    capacityHeight = 0;
+}
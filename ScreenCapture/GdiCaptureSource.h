@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Windows.h>
+#include <cstdint>
+#include "CaptureSource.h"
+
+// Captures screen regions into a reusable top-down 32bpp DIB section.
+// The DIB is only reallocated when a capture is larger than the current
+// capacity, so repeated captures of the same region allocate nothing.
+class GdiCaptureSource : public CaptureSource
+{
+public:
+    GdiCaptureSource();
+    ~GdiCaptureSource() override;
+
+    GdiCaptureSource(const GdiCaptureSource&) = delete;
+    GdiCaptureSource& operator=(const GdiCaptureSource&) = delete;
+
+    // Copy the given screen rectangle (virtual screen coordinates) into the DIB
+    bool capture(const Region& region, CaptureFrame& frame) override;
+
+private:
+    bool reserve(int width, int height);
+    void release();
+
+    HDC memoryDC;
+    HBITMAP dib;
+    HBITMAP oldBitmap;
+    uint8_t* pixels;
+    int capacityWidth;
+    int capacityHeight;
+};
@@ -0,0 +1,136 @@
+// HotkeyDispatcher.cpp
+#include "HotkeyDispatcher.h"
+
+namespace
+{
+    // Bit index of each modifier key in heldModifierKeys, -1 for non-modifiers
+    int modifierKeyIndex(uint32_t keyCode)
+    {
+        switch (keyCode)
+        {
+        case HotkeyDispatcher::KeyShift:        return 0;
+        case HotkeyDispatcher::KeyLeftShift:    return 1;
+        case HotkeyDispatcher::KeyRightShift:   return 2;
+        case HotkeyDispatcher::KeyControl:      return 3;
+        case HotkeyDispatcher::KeyLeftControl:  return 4;
+        case HotkeyDispatcher::KeyRightControl: return 5;
+        case HotkeyDispatcher::KeyAlt:          return 6;
+        case HotkeyDispatcher::KeyLeftAlt:      return 7;
+        case HotkeyDispatcher::KeyRightAlt:     return 8;
+        case HotkeyDispatcher::KeyLeftWin:      return 9;
+        case HotkeyDispatcher::KeyRightWin:     return 10;
+        default:                                return -1;
+        }
+    }
+
+    const uint32_t modifierKeys[] = {
+        HotkeyDispatcher::KeyShift, HotkeyDispatcher::KeyLeftShift, HotkeyDispatcher::KeyRightShift,
+        HotkeyDispatcher::KeyControl, HotkeyDispatcher::KeyLeftControl, HotkeyDispatcher::KeyRightControl,
+        HotkeyDispatcher::KeyAlt, HotkeyDispatcher::KeyLeftAlt, HotkeyDispatcher::KeyRightAlt,
+        HotkeyDispatcher::KeyLeftWin, HotkeyDispatcher::KeyRightWin,
+    };
+}
+
+HotkeyDispatcher::HotkeyDispatcher()
+    : heldModifierKeys(0), modifiers(ModNone), activeTriggerKey(0), overlayActive(false)
+{
+}
+
+void HotkeyDispatcher::bind(const Hotkey& hotkey)
+{
+    bindings.push_back(hotkey);
+}
+
+HotkeyDispatcher::Result HotkeyDispatcher::onKeyEvent(uint32_t keyCode, bool isKeyDown)
+{
+    int modifierIndex = modifierKeyIndex(keyCode);
+    if (modifierIndex >= 0)
+    {
+        if (isKeyDown)
+            heldModifierKeys |= static_cast<uint16_t>(1u << modifierIndex);
+        else
+            heldModifierKeys &= static_cast<uint16_t>(~(1u << modifierIndex));
+        updateModifiers();
+        return { HotkeyAction::None, false };
+    }
+
+    if (!isKeyDown)
+    {
+        // Swallow the release of a trigger key whose press we swallowed,
+        // so the foreground application never sees an orphaned key-up
+        if (keyCode == activeTriggerKey)
+        {
+            activeTriggerKey = 0;
+            return { HotkeyAction::None, true };
+        }
+        return { HotkeyAction::None, false };
+    }
+
+    // Auto-repeat of a held trigger key fires only once
+    if (keyCode == activeTriggerKey)
+        return { HotkeyAction::None, true };
+
+    for (const Hotkey& hotkey : bindings)
+    {
+        if (hotkey.keyCode != keyCode || hotkey.modifiers != modifiers)
+            continue;
+        if (hotkey.onlyWhileOverlay && !overlayActive)
+            continue;
+
+        activeTriggerKey = keyCode;
+        return { hotkey.action, true };
+    }
+
+    return { HotkeyAction::None, false };
+}
+
+void HotkeyDispatcher::setOverlayActive(bool active)
+{
+    overlayActive = active;
+}
+
+uint8_t HotkeyDispatcher::getModifiers() const
+{
+    return modifiers;
+}
+
+void HotkeyDispatcher::reset()
+{
+    heldModifierKeys = 0;
+    modifiers = ModNone;
+    activeTriggerKey = 0;
+}
+
+uint8_t HotkeyDispatcher::modifierFlag(uint32_t keyCode)
+{
+    switch (keyCode)
+    {
+    case KeyShift:
+    case KeyLeftShift:
+    case KeyRightShift:
+        return ModShift;
+    case KeyControl:
+    case KeyLeftControl:
+    case KeyRightControl:
+        return ModControl;
+    case KeyAlt:
+    case KeyLeftAlt:
+    case KeyRightAlt:
+        return ModAlt;
+    case KeyLeftWin:
+    case KeyRightWin:
+        return ModWin;
+    default:
+        return ModNone;
+    }
+}
+
+void HotkeyDispatcher::updateModifiers()
+{
+    modifiers = ModNone;
+    for (uint32_t keyCode : modifierKeys)
+    {
+        if (heldModifierKeys & (1u << modifierKeyIndex(keyCode)))
+            modifiers |= modifierFlag(keyCode);
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Actions a hotkey can trigger. The values are posted as the WPARAM of
+// WM_HOTKEY_ACTION, so they must stay stable.
+enum class HotkeyAction
+{
+    None = 0,
+    Capture,            // Show the selection overlay (or hide it if already visible)
+    RepeatLastRegion,   // Capture the previously selected region again
+    ToggleWatch,        // Start/stop repeating the last region periodically
+    Cancel,             // Close the overlay without capturing
+};
+
+// Modifier bit flags used by hotkey bindings.
+enum HotkeyModifier : uint8_t
+{
+    ModNone = 0,
+    ModControl = 1 << 0,
+    ModShift = 1 << 1,
+    ModAlt = 1 << 2,
+    ModWin = 1 << 3,
+};
+
+struct Hotkey
+{
+    HotkeyAction action;
+    uint8_t modifiers;          // Combination of HotkeyModifier flags, matched exactly
+    uint32_t keyCode;           // Virtual-key code of the trigger key
+    bool onlyWhileOverlay;      // Only active while the selection overlay is shown
+};
+
+// Platform-neutral hotkey state machine fed from the low-level keyboard hook.
+//
+// Modifier state is tracked from the key event stream itself, so the hook never
+// has to query GetAsyncKeyState. Key codes use the Windows virtual-key values,
+// but nothing here depends on Windows headers.
+class HotkeyDispatcher
+{
+public:
+    struct Result
+    {
+        HotkeyAction action;    // Action to dispatch, None if nothing fired
+        bool swallow;           // True if the event must not reach other applications
+    };
+
+    // Virtual-key codes of the keys treated as modifiers
+    static constexpr uint32_t KeyShift = 0x10;
+    static constexpr uint32_t KeyControl = 0x11;
+    static constexpr uint32_t KeyAlt = 0x12;
+    static constexpr uint32_t KeyLeftWin = 0x5B;
+    static constexpr uint32_t KeyRightWin = 0x5C;
+    static constexpr uint32_t KeyLeftShift = 0xA0;
+    static constexpr uint32_t KeyRightShift = 0xA1;
+    static constexpr uint32_t KeyLeftControl = 0xA2;
+    static constexpr uint32_t KeyRightControl = 0xA3;
+    static constexpr uint32_t KeyLeftAlt = 0xA4;
+    static constexpr uint32_t KeyRightAlt = 0xA5;
+
+    HotkeyDispatcher();
+
+    void bind(const Hotkey& hotkey);
+
+    // Feed one key event. Returns the action to dispatch, if any.
+    Result onKeyEvent(uint32_t keyCode, bool isKeyDown);
+
+    void setOverlayActive(bool active);
+
+    uint8_t getModifiers() const;
+    // Forget all held keys, e.g. after a desktop switch swallowed the key-ups.
+    void reset();
+
+private:
+    static uint8_t modifierFlag(uint32_t keyCode);
+    void updateModifiers();
+
+    std::vector<Hotkey> bindings;
+    // Held state of the individual left/right modifier keys, so releasing one
+    // side does not clear a modifier that is still held on the other.
+    uint16_t heldModifierKeys;
+    uint8_t modifiers;
+    uint32_t activeTriggerKey;  // Trigger key of the hotkey that fired, until released
+    bool overlayActive;
+};
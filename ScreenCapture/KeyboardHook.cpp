@@ -0,0 +1,215 @@
+// KeyboardHook.cpp
+#include "KeyboardHook.h"
+
+namespace
+{
+    // Thread messages understood by the hook thread
+    const UINT HookSetOverlay = WM_APP + 1;     // WPARAM: overlay active
+    const UINT HookReset = WM_APP + 2;
+    const UINT HookVerify = WM_APP + 3;        // WPARAM: see packVerify, LPARAM: event time
+
+    // dwExtraInfo of the keys replayed after a failed verification, so the
+    // hook lets them through instead of matching them again
+    const ULONG_PTR ReplayTag = 0x53435250;     // 'SCRP'
+
+    WPARAM packVerify(HotkeyAction action, uint8_t modifiers, DWORD keyCode, bool extended)
+    {
+        return static_cast<WPARAM>(action) | (static_cast<WPARAM>(modifiers) << 8) |
+            (static_cast<WPARAM>(keyCode & 0xFF) << 16) | (static_cast<WPARAM>(extended ? 1 : 0) << 24);
+    }
+
+    // Side-specific modifier keys, as reported by the low-level hook
+    const uint32_t sidedModifierKeys[] = {
+        VK_LSHIFT, VK_RSHIFT, VK_LCONTROL, VK_RCONTROL, VK_LMENU, VK_RMENU, VK_LWIN, VK_RWIN,
+    };
+}
+
+KeyboardHook* KeyboardHook::instance = nullptr;
+
+KeyboardHook::KeyboardHook()
+    : targetWindow(NULL), actionMessage(0), hook(NULL), threadId(0), installError(ERROR_SUCCESS)
+{
+}
+
+KeyboardHook::~KeyboardHook()
+{
+    stop();
+}
+
+void KeyboardHook::bind(const Hotkey& hotkey)
+{
+    dispatcher.bind(hotkey);
+}
+
+bool KeyboardHook::start(HWND window, UINT message)
+{
+    if (thread.joinable() || instance)
+        return false;
+
+    targetWindow = window;
+    actionMessage = message;
+    instance = this;
+
+    HANDLE readyEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    if (!readyEvent)
+    {
+        instance = nullptr;
+        return false;
+    }
+
+    bool installed = false;
+    thread = std::thread(&KeyboardHook::run, this, readyEvent, &installed);
+    WaitForSingleObject(readyEvent, INFINITE);
+    CloseHandle(readyEvent);
+
+    if (!installed)
+    {
+        thread.join();
+        instance = nullptr;
+        // The error belongs to the hook thread, hand it to the caller
+        SetLastError(installError);
+    }
+    return installed;
+}
+
+void KeyboardHook::stop()
+{
+    if (!thread.joinable())
+        return;
+
+    PostThreadMessage(threadId, WM_QUIT, 0, 0);
+    thread.join();
+    instance = nullptr;
+}
+
+void KeyboardHook::setOverlayActive(bool active)
+{
+    PostThreadMessage(threadId, HookSetOverlay, active ? 1 : 0, 0);
+}
+
+void KeyboardHook::reset()
+{
+    PostThreadMessage(threadId, HookReset, 0, 0);
+}
+
+const LatencyStats& KeyboardHook::getCallbackLatency() const
+{
+    return callbackLatency;
+}
+
+void KeyboardHook::run(HANDLE readyEvent, bool* installed)
+{
+    // Make sure the thread has a message queue before anyone posts to it
+    MSG msg;
+    PeekMessage(&msg, NULL, WM_USER, WM_USER, PM_NOREMOVE);
+    threadId = GetCurrentThreadId();
+
+    hook = SetWindowsHookEx(WH_KEYBOARD_LL, hookCallback, GetModuleHandle(NULL), 0);
+    *installed = hook != NULL;
+    installError = hook ? ERROR_SUCCESS : GetLastError();
+    SetEvent(readyEvent);
+    if (!hook)
+        return;
+
+    // Pumping messages is what lets Windows call the hook on this thread
+    while (GetMessage(&msg, NULL, 0, 0) > 0)
+    {
+        switch (msg.message)
+        {
+        case HookSetOverlay:
+            dispatcher.setOverlayActive(msg.wParam != 0);
+            break;
+        case HookReset:
+            dispatcher.reset();
+            break;
+        case HookVerify:
+        {
+            // Runs right after the callback returned, while the keys are still held
+            HotkeyAction action = static_cast<HotkeyAction>(msg.wParam & 0xFF);
+            uint8_t modifiers = static_cast<uint8_t>((msg.wParam >> 8) & 0xFF);
+            uint32_t keyCode = static_cast<uint32_t>((msg.wParam >> 16) & 0xFF);
+            bool extended = ((msg.wParam >> 24) & 1) != 0;
+            if (syncModifiers() == modifiers)
+            {
+                PostMessage(targetWindow, actionMessage, static_cast<WPARAM>(action), msg.lParam);
+                break;
+            }
+
+            // Matched against a stale modifier, so the swallowed key was meant
+            // for the foreground application. Stop swallowing its release; the
+            // dispatcher only swallows it while the key-up has not been seen,
+            // which tells whether the key is still held.
+            bool stillHeld = dispatcher.onKeyEvent(keyCode, false).swallow;
+            replayKey(keyCode, extended, !stillHeld);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    UnhookWindowsHookEx(hook);
+    hook = NULL;
+}
+
+LRESULT CALLBACK KeyboardHook::hookCallback(int nCode, WPARAM wParam, LPARAM lParam)
+{
+    return instance->onKey(nCode, wParam, lParam);
+}
+
+LRESULT KeyboardHook::onKey(int nCode, WPARAM wParam, LPARAM lParam)
+{
+    // Check if the hook can process the event
+    if (nCode == HC_ACTION)
+    {
+        // Keep this path short: anything slow here delays every keystroke system-wide
+        ScopedLatency timing(callbackLatency);
+
+        KBDLLHOOKSTRUCT* pKeyboardStruct = reinterpret_cast<KBDLLHOOKSTRUCT*>(lParam);
+        if (pKeyboardStruct->dwExtraInfo == ReplayTag)
+            return CallNextHookEx(hook, nCode, wParam, lParam);
+
+        bool isKeyDown = wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN;
+
+        HotkeyDispatcher::Result result = dispatcher.onKeyEvent(pKeyboardStruct->vkCode, isKeyDown);
+        if (result.action != HotkeyAction::None)
+        {
+            WPARAM verify = packVerify(result.action, dispatcher.getModifiers(), pKeyboardStruct->vkCode, (pKeyboardStruct->flags & LLKHF_EXTENDED) != 0);
+            PostThreadMessage(threadId, HookVerify, verify, static_cast<LPARAM>(pKeyboardStruct->time));
+        }
+        if (result.swallow)
+            return 1;
+    }
+
+    // Call the next hook in the hook chain
+    return CallNextHookEx(hook, nCode, wParam, lParam);
+}
+
+uint8_t KeyboardHook::syncModifiers()
+{
+    // Feed the real key state back into the dispatcher. The generic codes are
+    // released since the side-specific ones fully describe the state.
+    for (uint32_t keyCode : sidedModifierKeys)
+        dispatcher.onKeyEvent(keyCode, (GetAsyncKeyState(keyCode) & 0x8000) != 0);
+    dispatcher.onKeyEvent(VK_SHIFT, false);
+    dispatcher.onKeyEvent(VK_CONTROL, false);
+    dispatcher.onKeyEvent(VK_MENU, false);
+
+    return dispatcher.getModifiers();
+}
+
+void KeyboardHook::replayKey(uint32_t keyCode, bool extended, bool withRelease)
+{
+    INPUT inputs[2] = {};
+    for (INPUT& input : inputs)
+    {
+        input.type = INPUT_KEYBOARD;
+        input.ki.wVk = static_cast<WORD>(keyCode);
+        input.ki.wScan = static_cast<WORD>(MapVirtualKey(keyCode, MAPVK_VK_TO_VSC));
+        input.ki.dwFlags = extended ? KEYEVENTF_EXTENDEDKEY : 0;
+        input.ki.dwExtraInfo = ReplayTag;
+    }
+    inputs[1].ki.dwFlags |= KEYEVENTF_KEYUP;
+
+    SendInput(withRelease ? 2 : 1, inputs, sizeof(INPUT));
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Windows.h>
+#include <thread>
+#include "HotkeyDispatcher.h"
+#include "LatencyStats.h"
+
+// Owns the low-level keyboard hook and runs it on a dedicated thread.
+//
+// Windows calls a WH_KEYBOARD_LL hook on the thread that installed it, and
+// only while that thread pumps messages. Keeping that thread free of any other
+// work means capture and OCR on the UI thread can never stall keyboard input
+// or get the hook silently removed after LowLevelHooksTimeout.
+//
+// Modifier state is tracked from the hook stream. Key-ups on the secure
+// desktop never reach the hook, so before an action is posted the held
+// modifiers are re-read with GetAsyncKeyState (outside the callback) and a
+// hotkey matched against stale state is dropped. Its trigger key was already
+// swallowed by then, so it is replayed with SendInput (tagged through
+// dwExtraInfo so the hook ignores it) and the application still gets it.
+//
+// Matched hotkeys are posted to the target window as actionMessage with the
+// HotkeyAction in WPARAM and the event's KBDLLHOOKSTRUCT::time in LPARAM.
+class KeyboardHook
+{
+public:
+    KeyboardHook();
+    ~KeyboardHook();
+
+    KeyboardHook(const KeyboardHook&) = delete;
+    KeyboardHook& operator=(const KeyboardHook&) = delete;
+
+    // Bindings must be set up before start()
+    void bind(const Hotkey& hotkey);
+    // On failure GetLastError() tells why the hook could not be installed
+    bool start(HWND targetWindow, UINT actionMessage);
+    void stop();
+
+    // Forwarded to the hook thread, safe to call from any thread
+    void setOverlayActive(bool active);
+    // Forget held keys, e.g. after a session lock or switch
+    void reset();
+
+    // Time spent inside the hook callback
+    const LatencyStats& getCallbackLatency() const;
+
+private:
+    static LRESULT CALLBACK hookCallback(int nCode, WPARAM wParam, LPARAM lParam);
+    void run(HANDLE readyEvent, bool* installed);
+    LRESULT onKey(int nCode, WPARAM wParam, LPARAM lParam);
+    uint8_t syncModifiers();
+    void replayKey(uint32_t keyCode, bool extended, bool withRelease);
+
+    static KeyboardHook* instance;  // Target of the hook callback
+
+    HotkeyDispatcher dispatcher;    // Only touched on the hook thread after start()
+    LatencyStats callbackLatency;
+    HWND targetWindow;
+    UINT actionMessage;
+    HHOOK hook;
+    std::thread thread;
+    DWORD threadId;
+    DWORD installError;             // GetLastError() of a failed SetWindowsHookEx
+};
@@ -0,0 +1,74 @@
+// LatencyStats.cpp
+#include "LatencyStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+LatencyStats::LatencyStats(size_t capacity)
+    : samples(capacity > 0 ? capacity : 1), next(0), filled(0)
+{
+}
+
+void LatencyStats::record(Duration sample)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    samples[next] = sample;
+    next = (next + 1) % samples.size();
+    if (filled < samples.size())
+        ++filled;
+}
+
+void LatencyStats::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    next = 0;
+    filled = 0;
+}
+
+size_t LatencyStats::count() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return filled;
+}
+
+LatencyStats::Duration LatencyStats::percentile(double p) const
+{
+    std::vector<Duration> sorted;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sorted.assign(samples.begin(), samples.begin() + filled);
+    }
+    if (sorted.empty())
+        return Duration::zero();
+
+    p = std::clamp(p, 0.0, 100.0);
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    size_t index = rank > 0 ? rank - 1 : 0;
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+}
+
+LatencyStats::Duration LatencyStats::maximum() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (filled == 0)
+        return Duration::zero();
+
+    return *std::max_element(samples.begin(), samples.begin() + filled);
+}
+
+std::string LatencyStats::summary() const
+{
+    auto us = [](Duration d) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    };
+
+    std::ostringstream out;
+    out << "n=" << count()
+        << " p50=" << us(percentile(50)) << "us"
+        << " p95=" << us(percentile(95)) << "us"
+        << " p99=" << us(percentile(99)) << "us"
+        << " max=" << us(maximum()) << "us";
+    return out.str();
+}
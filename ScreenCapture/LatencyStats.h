@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Keeps the most recent latency samples in a fixed ring buffer so recording
+// never allocates. Percentiles are computed on demand from a copy.
+// Safe to record from one thread while another reads the summary.
+class LatencyStats
+{
+public:
+    using Duration = std::chrono::nanoseconds;
+
+    explicit LatencyStats(size_t capacity = 1024);
+
+    void record(Duration sample);
+    void clear();
+
+    size_t count() const;
+    Duration percentile(double p) const;   // p in [0, 100]
+    Duration maximum() const;
+
+    // Human-readable summary, e.g. "n=120 p50=3us p95=11us p99=40us max=52us"
+    std::string summary() const;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<Duration> samples;
+    size_t next;
+    size_t filled;
+};
+
+// Records the lifetime of the scope into a LatencyStats instance.
+class ScopedLatency
+{
+public:
+    explicit ScopedLatency(LatencyStats& stats)
+        : stats(stats), start(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency()
+    {
+        stats.record(std::chrono::duration_cast<LatencyStats::Duration>(std::chrono::steady_clock::now() - start));
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyStats& stats;
+    std::chrono::steady_clock::time_point start;
+};
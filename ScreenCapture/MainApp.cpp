@@ -2,26 +2,65 @@
 #include "OCRProcessor.h"
 #include "WindowData.h"
 #include "Resource.h"
+#include "KeyboardHook.h"
+#include "LatencyStats.h"
+#include "Settings.h"
+#include "GdiCaptureSource.h"
 
 #include <windows.h>
 #include <gdiplus.h>
+#include <wtsapi32.h>
 #include <iostream>
 #include <cstddef>
 #include "WindowPainter.h"
 #pragma comment (lib, "Gdiplus.lib")
+#pragma comment (lib, "Wtsapi32.lib")
+
+// Window messages and timers
+#define WM_TRAYICON         (WM_USER + 1)
+#define WM_HOTKEY_ACTION    (WM_USER + 2)   // WPARAM: HotkeyAction, LPARAM: key event time
+#define WATCH_TIMER_ID      1
+#define WATCH_INTERVAL_MS   2000
+#define PROFILE_COMMAND_BASE 100            // Tray menu command of the first profile
 
 // Global variables
 bool g_isMouseDown = false;
 WindowPainter* painter = nullptr;
+HWND g_hWnd = NULL;
+KeyboardHook g_keyboardHook;
+LatencyStats g_dispatchLatency;
+LatencyStats g_captureLatency;
+LatencyStats g_recognizeLatency;
+LatencyStats g_coldStartLatency;
+LatencyStats g_profileSwitchLatency;
+Settings g_settings;
+std::string g_settingsPath;
+std::string g_tessdataPath;
+bool g_settingsLoadedFromFile = false;  // False when running on defaults after a failed load
+LatencyStats::Duration g_settingsLoadTime;  // First part of the cold start
 
 // Hooks
 LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
-LRESULT CALLBACK KeyboardHookCallback(int nCode, WPARAM wParam, LPARAM lParam);
 
 // Function to capture the screen content
 HBITMAP CaptureScreen(int rectX, int rectY, int rectWidth, int rectHeight);
+// Function to OCR a screen region and put the text on the clipboard
+void CopyRegionTextToClipboard(HWND hWnd, const Region& region, bool skipIfUnchanged);
+// Function to find the cached region for the monitor under the cursor
+bool FindRepeatRegion(WindowData* windowRes, Region& region);
+// Function to fit the overlay to the virtual screen after monitor changes
+void UpdateOverlayGeometry(HWND hWnd, WindowData* windowRes);
+// Functions to show and hide the selection overlay
+void ShowOverlay(HWND hWnd, WindowData* windowRes);
+void HideOverlay(HWND hWnd, WindowData* windowRes);
+// Function to handle an action posted by the keyboard hook thread
+void HandleHotkeyAction(HWND hWnd, HotkeyAction action);
+// Function to load the settings file next to the executable
+void LoadSettings();
+// Function to switch the active OCR profile and persist the choice
+void SwitchProfile(HWND hWnd, int index);
 // Function to initialize WindowData and set it in the window's extra bytes
-void InitializeWindowResources(HWND hWnd);
+bool InitializeWindowResources(HWND hWnd);
 // Function to deallocate WindowData and associated resources
 void DeallocateWindowResources(HWND hWnd);
 
@@ -46,9 +85,18 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
 
     RegisterClassEx(&wcex);
 
-    // Get the screen width and height
-    int screenWidth = GetSystemMetrics(SM_CXSCREEN);
-    int screenHeight = GetSystemMetrics(SM_CYSCREEN);
+    // The overlay covers the virtual screen, i.e. every monitor
+    int screenX = GetSystemMetrics(SM_XVIRTUALSCREEN);
+    int screenY = GetSystemMetrics(SM_YVIRTUALSCREEN);
+    int screenWidth = GetSystemMetrics(SM_CXVIRTUALSCREEN);
+    int screenHeight = GetSystemMetrics(SM_CYVIRTUALSCREEN);
+
+    // Cold start covers loading the settings, compiling the profiles and
+    // initializing the OCR engines during window creation. The rest of the
+    // window creation (the full screen capture) is not part of it.
+    auto settingsBegin = std::chrono::steady_clock::now();
+    LoadSettings();
+    g_settingsLoadTime = std::chrono::duration_cast<LatencyStats::Duration>(std::chrono::steady_clock::now() - settingsBegin);
 
     // Create the window
     HWND hWnd = CreateWindowEx(
@@ -56,7 +104,7 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
         CLASS_NAME,                     // Window class name
         L"Screen Copy Window",          // Window title
         WS_POPUP,                       // Window style - Fullscreen popup window
-        0, 0, screenWidth, screenHeight,// Window position and dimensions
+        screenX, screenY, screenWidth, screenHeight, // Window position and dimensions
         NULL,                           // Parent window
         NULL,                           // Menu handle
         hInstance,                      // Instance handle
@@ -66,15 +114,33 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
     if (hWnd == NULL)
         return 0;
 
+    g_hWnd = hWnd;
+
     // Create and add the tray icon
-    TrayIcon trayIcon(hWnd, hInstance, WM_USER + 1, LoadIcon(hInstance, MAKEINTRESOURCE(IDI_SMALL)));
+    TrayIcon trayIcon(hWnd, hInstance, WM_TRAYICON, LoadIcon(hInstance, MAKEINTRESOURCE(IDI_SMALL)));
     trayIcon.Add();
 
-    // Set the global keyboard hook
-    HHOOK hHook = SetWindowsHookEx(WH_KEYBOARD_LL, KeyboardHookCallback, hInstance, 0);
+    // Configure the hotkeys
+    for (const Hotkey& hotkey : g_settings.hotkeys)
+        g_keyboardHook.bind(hotkey);
+
+    // Set the global keyboard hook on its own thread
+    if (!g_keyboardHook.start(hWnd, WM_HOTKEY_ACTION))
+    {
+        std::string message = "Failed to install the keyboard hook: " + GetLastErrorString() +
+            "\n\nThe shortcuts will not work. Exit the application from the system tray icon.";
+        MessageBoxA(NULL, message.c_str(), "Keyboard hook", MB_OK | MB_ICONWARNING);
+    }
+    // Lock/unlock and session switches swallow key-ups, get told about them
+    WTSRegisterSessionNotification(hWnd, NOTIFY_FOR_THIS_SESSION);
 
     // Create the painting handler
-    painter = new WindowPainter(hWnd, { 156, 0, 0, 0 }, { 240, 255, 255, 255 }, 2);
+    const ColorARGB& overlay = g_settings.overlayColor;
+    const ColorARGB& border = g_settings.borderColor;
+    painter = new WindowPainter(hWnd,
+        Gdiplus::Color(overlay.a, overlay.r, overlay.g, overlay.b),
+        Gdiplus::Color(border.a, border.r, border.g, border.b),
+        g_settings.borderWidth);
 
     // Message loop
     MSG msg;
@@ -87,11 +153,7 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR pCmdLine
     // Clean up TrayIcon
     trayIcon.Remove();
     // Clean up hook
-    if (hHook != NULL)
-    {
-        UnhookWindowsHookEx(hHook);
-        hHook = NULL;
-    }
+    g_keyboardHook.stop();
     // Clean up the painter
     if (painter != NULL) {
         delete painter;
@@ -109,7 +171,9 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
     {
     case WM_CREATE:
     {
-        InitializeWindowResources(hWnd);
+        // Returning -1 makes CreateWindowEx fail instead of running without OCR
+        if (!InitializeWindowResources(hWnd))
+            return -1;
         break;
     }
 
@@ -163,40 +227,19 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         InvalidateRect(hWnd, NULL, FALSE);
         WindowData* windowRes = reinterpret_cast<WindowData*>(GetWindowLongPtr(hWnd, 0));
         if (windowRes && windowRes->isWindowVisible) {
-            ShowWindow(hWnd, SW_HIDE);
-            windowRes->isWindowVisible = false;
+            HideOverlay(hWnd, windowRes);
 
-            // Get the selected region coordinates
+            // Get the selected region coordinates, relative to the virtual screen
             Gdiplus::Rect selectedRectangle = painter->getRect();
-            // Capture the image from the selected region
-            HBITMAP hBitmap = CaptureScreen(selectedRectangle.X, selectedRectangle.Y, selectedRectangle.Width, selectedRectangle.Height);
+            Region region = { selectedRectangle.X + windowRes->originX, selectedRectangle.Y + windowRes->originY, selectedRectangle.Width, selectedRectangle.Height };
 
-            // Perform OCR on the bitmap
-            WindowData* windowRes = reinterpret_cast<WindowData*>(GetWindowLongPtr(hWnd, 0));
-            std::string ocrText = windowRes->ocr->performOCR(hBitmap);
+            // Remember the region for repeated captures on this monitor
+            RECT screenRect;
+            SetRect(&screenRect, region.x, region.y, region.x + region.width, region.y + region.height);
+            HMONITOR hMonitor = MonitorFromRect(&screenRect, MONITOR_DEFAULTTONEAREST);
+            windowRes->lastRegions->remember(reinterpret_cast<uintptr_t>(hMonitor), region);
 
-            // Open the clipboard
-            if (OpenClipboard(hWnd))
-            {
-                // Empty the clipboard
-                EmptyClipboard();
-
-                // Set the OCR text to the clipboard
-                const char* output = ocrText.c_str();
-                size_t len = strlen(output) + 1;
-                HGLOBAL hMem = GlobalAlloc(GMEM_MOVEABLE, len);
-                memcpy(GlobalLock(hMem), output, len);
-                GlobalUnlock(hMem);
-                SetClipboardData(CF_TEXT, hMem);
-
-                // Close the clipboard
-                CloseClipboard();
-            }
-            else
-            {
-                // Failed to open the clipboard
-                MessageBox(hWnd, L"Failed to open the clipboard.", L"Error", MB_OK | MB_ICONERROR);
-            }
+            CopyRegionTextToClipboard(hWnd, region, false);
         }
         painter->createSelectedRect(0, 0);
 
@@ -215,8 +258,36 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         break;
     }
 
+    case WM_HOTKEY_ACTION:
+    {
+        // Delay from the key event to handling it here, in the tick count's resolution
+        DWORD eventTime = static_cast<DWORD>(lParam);
+        g_dispatchLatency.record(std::chrono::milliseconds(GetTickCount() - eventTime));
+
+        HandleHotkeyAction(hWnd, static_cast<HotkeyAction>(wParam));
+        return 0;
+    }
+
+    case WM_TIMER:
+    {
+        WindowData* windowRes = reinterpret_cast<WindowData*>(GetWindowLongPtr(hWnd, 0));
+        if (wParam == WATCH_TIMER_ID && windowRes && windowRes->isWatching && !windowRes->isWindowVisible)
+            CopyRegionTextToClipboard(hWnd, windowRes->watchRegion, true);
+        return 0;
+    }
+
+    case WM_WTSSESSION_CHANGE:
+    {
+        // Key-ups that happened on the secure desktop never reached the hook
+        g_keyboardHook.reset();
+        return 0;
+    }
+
     case WM_DESTROY:
     {
+        KillTimer(hWnd, WATCH_TIMER_ID);
+        WTSUnRegisterSessionNotification(hWnd);
+
         // Clean up the resources
         DeallocateWindowResources(hWnd);
 
@@ -224,14 +295,26 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         break;
     }
 
-    case WM_USER + 1:
+    case WM_TRAYICON:
         switch (lParam)
         {
         case WM_RBUTTONUP:
         {
             // Show a context menu when right-clicking on the tray icon
 
+            WindowData* windowRes = reinterpret_cast<WindowData*>(GetWindowLongPtr(hWnd, 0));
+            int activeProfile = windowRes ? windowRes->ocr->getProfile() : -1;
+
+            HMENU hProfileMenu = CreatePopupMenu();
+            for (size_t i = 0; i < g_settings.profiles.size(); ++i)
+            {
+                UINT flags = MF_STRING | (static_cast<int>(i) == activeProfile ? MF_CHECKED : MF_UNCHECKED);
+                AppendMenuA(hProfileMenu, flags, PROFILE_COMMAND_BASE + i, g_settings.profiles[i].name.c_str());
+            }
+
             HMENU hPopupMenu = CreatePopupMenu();
+            AppendMenu(hPopupMenu, MF_POPUP, reinterpret_cast<UINT_PTR>(hProfileMenu), L"Profile");
+            AppendMenu(hPopupMenu, MF_STRING, 2, L"Latency statistics");
             AppendMenu(hPopupMenu, MF_STRING, 1, L"Exit");
 
             POINT cursorPos;
@@ -258,6 +341,27 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             // Exit menu item
             DestroyWindow(hWnd);
             break;
+        case 2:
+        {
+            // Latency statistics menu item
+            std::string summary =
+                "Keyboard hook callback:\n" + g_keyboardHook.getCallbackLatency().summary() +
+                "\n\nKey event to dispatch:\n" + g_dispatchLatency.summary() +
+                "\n\nRegion capture:\n" + g_captureLatency.summary() +
+                "\n\nRecognition:\n" + g_recognizeLatency.summary() +
+                "\n\nCold start:\n" + g_coldStartLatency.summary() +
+                "\n\nProfile switch:\n" + g_profileSwitchLatency.summary();
+            MessageBoxA(hWnd, summary.c_str(), "Latency statistics", MB_OK | MB_ICONINFORMATION);
+            break;
+        }
+        default:
+        {
+            // Profile menu items
+            int profileIndex = static_cast<int>(LOWORD(wParam)) - PROFILE_COMMAND_BASE;
+            if (profileIndex >= 0 && profileIndex < static_cast<int>(g_settings.profiles.size()))
+                SwitchProfile(hWnd, profileIndex);
+            break;
+        }
         }
 
         return 0;
@@ -269,60 +373,167 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
     return 0;
 }
 
-LRESULT CALLBACK KeyboardHookCallback(int nCode, WPARAM wParam, LPARAM lParam)
+void HandleHotkeyAction(HWND hWnd, HotkeyAction action)
 {
-    // Check if the hook can process the event
-    if (nCode == HC_ACTION)
+    WindowData* windowRes = reinterpret_cast<WindowData*>(GetWindowLongPtr(hWnd, 0));
+    if (!windowRes)
+        return;
+
+    switch (action)
     {
-        KBDLLHOOKSTRUCT* pKeyboardStruct = reinterpret_cast<KBDLLHOOKSTRUCT*>(lParam);
+    case HotkeyAction::Capture:
+        if (!windowRes->isWindowVisible)
+        {
+            painter->createSelectedRect(0, 0);
+            UpdateOverlayGeometry(hWnd, windowRes);
+            if (windowRes->bitmap)
+                DeleteObject(windowRes->bitmap);
+            windowRes->bitmap = CaptureScreen(windowRes->originX, windowRes->originY, windowRes->windowWidth, windowRes->windowHeight);
 
-        // Check for your desired keyboard shortcut
-        if (pKeyboardStruct->vkCode == 'S' &&
-            (GetAsyncKeyState(VK_CONTROL) & 0x8000) != 0 &&
-            (GetAsyncKeyState(VK_LWIN) & 0x8000) != 0)
+            ShowOverlay(hWnd, windowRes);
+        }
+        else
         {
-            HWND hWnd = FindWindow(L"ScreenCopyWindowClass", NULL);
-            if (hWnd != NULL)
-            {
-                // Get the OCRProcessor object from the window's extra bytes
-                WindowData* windowRes = reinterpret_cast<WindowData*>(GetWindowLongPtr(hWnd, 0));
-                if (windowRes && !windowRes->isWindowVisible)
-                {
-                    painter->createSelectedRect(0, 0);
-                    HBITMAP hBitmap = CaptureScreen(0, 0, windowRes->windowWidth, windowRes->windowHeight);
-                    windowRes->bitmap = hBitmap;
-
-                    ShowWindow(hWnd, SW_SHOW);
-                    windowRes->isWindowVisible = true;
-                }
-                else if (windowRes)
-                {
-                    ShowWindow(hWnd, SW_HIDE);
-                    windowRes->isWindowVisible = false;
-                }
-            }
-            return 1;
+            HideOverlay(hWnd, windowRes);
         }
-        else if (pKeyboardStruct->vkCode == VK_ESCAPE)
+        break;
+
+    case HotkeyAction::Cancel:
+        if (windowRes->isWindowVisible)
         {
-            HWND hWnd = FindWindow(L"ScreenCopyWindowClass", NULL);
-            if (hWnd != NULL)
-            {
-                WindowData* windowRes = reinterpret_cast<WindowData*>(GetWindowLongPtr(hWnd, 0));
-                if (windowRes && windowRes->isWindowVisible)
-                {
-                    painter->createSelectedRect(0, 0);
-
-                    ShowWindow(hWnd, SW_HIDE);
-                    windowRes->isWindowVisible = false;
-                }
-            }
-            return 1;
+            painter->createSelectedRect(0, 0);
+            HideOverlay(hWnd, windowRes);
         }
+        break;
+
+    case HotkeyAction::RepeatLastRegion:
+    {
+        // Capture the cached region directly, the overlay is never shown
+        Region region;
+        if (!windowRes->isWindowVisible && FindRepeatRegion(windowRes, region))
+            CopyRegionTextToClipboard(hWnd, region, false);
+        break;
     }
 
-    // Call the next hook in the hook chain
-    return CallNextHookEx(NULL, nCode, wParam, lParam);
+    case HotkeyAction::ToggleWatch:
+        if (windowRes->isWatching)
+        {
+            KillTimer(hWnd, WATCH_TIMER_ID);
+            windowRes->isWatching = false;
+        }
+        else if (FindRepeatRegion(windowRes, windowRes->watchRegion))
+        {
+            windowRes->lastOcrText.clear();
+            SetTimer(hWnd, WATCH_TIMER_ID, WATCH_INTERVAL_MS, NULL);
+            windowRes->isWatching = true;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void ShowOverlay(HWND hWnd, WindowData* windowRes)
+{
+    ShowWindow(hWnd, SW_SHOW);
+    windowRes->isWindowVisible = true;
+    g_keyboardHook.setOverlayActive(true);
+}
+
+void HideOverlay(HWND hWnd, WindowData* windowRes)
+{
+    ShowWindow(hWnd, SW_HIDE);
+    windowRes->isWindowVisible = false;
+    g_keyboardHook.setOverlayActive(false);
+}
+
+void UpdateOverlayGeometry(HWND hWnd, WindowData* windowRes)
+{
+    int screenX = GetSystemMetrics(SM_XVIRTUALSCREEN);
+    int screenY = GetSystemMetrics(SM_YVIRTUALSCREEN);
+    int screenWidth = GetSystemMetrics(SM_CXVIRTUALSCREEN);
+    int screenHeight = GetSystemMetrics(SM_CYVIRTUALSCREEN);
+    if (screenX == windowRes->originX && screenY == windowRes->originY &&
+        screenWidth == windowRes->windowWidth && screenHeight == windowRes->windowHeight)
+        return;
+
+    // A monitor was added, removed or moved
+    windowRes->originX = screenX;
+    windowRes->originY = screenY;
+    SetWindowPos(hWnd, NULL, screenX, screenY, screenWidth, screenHeight, SWP_NOZORDER | SWP_NOACTIVATE);
+
+    HDC hdc = GetDC(hWnd);
+    if (windowRes->memoryBitmap)
+        DeleteObject(windowRes->memoryBitmap);
+    windowRes->memoryBitmap = CreateCompatibleBitmap(hdc, screenWidth, screenHeight);
+    ReleaseDC(hWnd, hdc);
+
+    // WM_SIZE already did this unless only the origin moved
+    windowRes->windowWidth = screenWidth;
+    windowRes->windowHeight = screenHeight;
+}
+
+bool FindRepeatRegion(WindowData* windowRes, Region& region)
+{
+    // Prefer the region selected on the monitor the cursor is on
+    POINT cursorPos;
+    if (GetCursorPos(&cursorPos))
+    {
+        HMONITOR hMonitor = MonitorFromPoint(cursorPos, MONITOR_DEFAULTTONULL);
+        if (hMonitor && windowRes->lastRegions->lookup(reinterpret_cast<uintptr_t>(hMonitor), region))
+            return true;
+    }
+
+    return windowRes->lastRegions->mostRecent(region);
+}
+
+void CopyRegionTextToClipboard(HWND hWnd, const Region& region, bool skipIfUnchanged)
+{
+    WindowData* windowRes = reinterpret_cast<WindowData*>(GetWindowLongPtr(hWnd, 0));
+    CaptureFrame frame;
+
+    // Capture the region into the pooled buffer
+    {
+        ScopedLatency timing(g_captureLatency);
+        if (!windowRes->captureSource->capture(region, frame))
+            return;
+    }
+
+    // Perform OCR on the captured pixels
+    std::string ocrText;
+    {
+        ScopedLatency timing(g_recognizeLatency);
+        ocrText = windowRes->ocr->performOCR(frame.pixels, frame.width, frame.height, frame.stride);
+    }
+
+    // Watch mode only touches the clipboard when the text actually changed
+    if (skipIfUnchanged && ocrText == windowRes->lastOcrText)
+        return;
+    windowRes->lastOcrText = ocrText;
+
+    // Open the clipboard
+    if (OpenClipboard(hWnd))
+    {
+        // Empty the clipboard
+        EmptyClipboard();
+
+        // Set the OCR text to the clipboard
+        const char* output = ocrText.c_str();
+        size_t len = strlen(output) + 1;
+        HGLOBAL hMem = GlobalAlloc(GMEM_MOVEABLE, len);
+        memcpy(GlobalLock(hMem), output, len);
+        GlobalUnlock(hMem);
+        SetClipboardData(CF_TEXT, hMem);
+
+        // Close the clipboard
+        CloseClipboard();
+    }
+    else if (!skipIfUnchanged)
+    {
+        // Failed to open the clipboard
+        MessageBox(hWnd, L"Failed to open the clipboard.", L"Error", MB_OK | MB_ICONERROR);
+    }
 }
 
 HBITMAP CaptureScreen(int rectX, int rectY, int rectWidth, int rectHeight)
@@ -342,6 +553,66 @@ HBITMAP CaptureScreen(int rectX, int rectY, int rectWidth, int rectHeight)
     return hBitmap;
 }
 
+void LoadSettings()
+{
+    char modulePath[MAX_PATH];
+    DWORD length = GetModuleFileNameA(NULL, modulePath, MAX_PATH);
+    std::string directory(modulePath, length);
+    directory = directory.substr(0, directory.find_last_of("\\/") + 1);
+    g_settingsPath = directory + "settings.ini";
+    g_tessdataPath = directory + "tessdata";
+
+    if (GetFileAttributesA(g_settingsPath.c_str()) == INVALID_FILE_ATTRIBUTES)
+    {
+        // First run: write the defaults so there is a file to edit
+        g_settings = Settings::defaults();
+        try {
+            g_settings.save(g_settingsPath);
+            g_settingsLoadedFromFile = true;
+        }
+        catch (const std::exception&) {
+            // Running from a read-only location is fine, the defaults still apply
+        }
+        return;
+    }
+
+    try {
+        g_settings = Settings::load(g_settingsPath);
+        g_settings.validateLanguages(g_tessdataPath);
+        g_settingsLoadedFromFile = true;
+    }
+    catch (const std::exception& e) {
+        std::string message = std::string(e.what()) + "\n\nUsing the default settings.";
+        MessageBoxA(NULL, message.c_str(), "Invalid settings", MB_OK | MB_ICONWARNING);
+        g_settings = Settings::defaults();
+        g_settingsLoadedFromFile = false;
+    }
+}
+
+void SwitchProfile(HWND hWnd, int index)
+{
+    WindowData* windowRes = reinterpret_cast<WindowData*>(GetWindowLongPtr(hWnd, 0));
+    if (!windowRes)
+        return;
+
+    {
+        ScopedLatency timing(g_profileSwitchLatency);
+        windowRes->ocr->setProfile(index);
+    }
+
+    // Remember the choice for the next start. When the file failed to load
+    // the defaults are in use and must not overwrite what the user wrote.
+    g_settings.activeProfile = g_settings.profiles[index].name;
+    if (!g_settingsLoadedFromFile)
+        return;
+    try {
+        Settings::saveActiveProfile(g_settingsPath, g_settings.activeProfile);
+    }
+    catch (const std::exception& e) {
+        MessageBoxA(hWnd, e.what(), "Failed to save settings", MB_OK | MB_ICONWARNING);
+    }
+}
+
 std::string GetLastErrorString()
 {
     DWORD errorCode = GetLastError();
@@ -373,30 +644,50 @@ std::string GetLastErrorString()
 }
 
 // Function to initialize WindowData and set it in the window's extra bytes
-void InitializeWindowResources(HWND hWnd)
+bool InitializeWindowResources(HWND hWnd)
 {
     WindowData* windowRes = new WindowData();
     try {
-        windowRes->ocr = new OCRProcessor();
+        auto ocrBegin = std::chrono::steady_clock::now();
+        windowRes->ocr = new OCRProcessor(g_settings.profiles, g_settings.activeProfileIndex(), g_tessdataPath);
+        g_coldStartLatency.record(g_settingsLoadTime + std::chrono::duration_cast<LatencyStats::Duration>(std::chrono::steady_clock::now() - ocrBegin));
     }
     catch (const std::exception& e) {
-        delete windowRes;
-        throw; // Rethrow the exception
+        // Validation only checks the files exist, a corrupt traineddata still
+        // fails here. Fall back to the defaults rather than not starting.
+        std::string message = std::string(e.what()) + "\n\nUsing the default settings.";
+        MessageBoxA(NULL, message.c_str(), "Failed to initialize OCR", MB_OK | MB_ICONWARNING);
+        g_settings = Settings::defaults();
+        g_settingsLoadedFromFile = false;
+        try {
+            windowRes->ocr = new OCRProcessor(g_settings.profiles, g_settings.activeProfileIndex(), g_tessdataPath);
+        }
+        catch (const std::exception& fallbackError) {
+            MessageBoxA(NULL, fallbackError.what(), "Failed to initialize OCR", MB_OK | MB_ICONERROR);
+            delete windowRes;
+            return false;
+        }
     }
 
-    int windowWidth = GetSystemMetrics(SM_CXSCREEN);  // width of client area
-    int windowHeight = GetSystemMetrics(SM_CYSCREEN); // height of client area
+    windowRes->captureSource = new GdiCaptureSource();
+    windowRes->lastRegions = new RegionCache();
+
+    int windowWidth = GetSystemMetrics(SM_CXVIRTUALSCREEN);  // width of client area
+    int windowHeight = GetSystemMetrics(SM_CYVIRTUALSCREEN); // height of client area
     windowRes->windowWidth = windowWidth;
     windowRes->windowHeight = windowHeight;
+    windowRes->originX = GetSystemMetrics(SM_XVIRTUALSCREEN);
+    windowRes->originY = GetSystemMetrics(SM_YVIRTUALSCREEN);
 
     HDC hdc = GetDC(hWnd);
 
-    windowRes->bitmap = CaptureScreen(0, 0, windowWidth, windowHeight);
+    windowRes->bitmap = CaptureScreen(windowRes->originX, windowRes->originY, windowWidth, windowHeight);
     windowRes->deviceContext = CreateCompatibleDC(hdc);
     windowRes->memoryBitmap = CreateCompatibleBitmap(hdc, windowWidth, windowHeight);
     ReleaseDC(hWnd, hdc);
 
     SetWindowLongPtr(hWnd, 0, reinterpret_cast<LONG_PTR>(windowRes));
+    return true;
 }
 
 // Function to deallocate WindowData and associated resources
@@ -406,6 +697,8 @@ void DeallocateWindowResources(HWND hWnd)
     if (windowRes)
     {
         delete windowRes->ocr;
+        delete windowRes->captureSource;
+        delete windowRes->lastRegions;
 
         if (windowRes->bitmap)
             DeleteObject(windowRes->bitmap);
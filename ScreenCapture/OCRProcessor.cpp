@@ -1,35 +1,145 @@
 // OCRProcessor.cpp
 #include "OCRProcessor.h"
 
-OCRProcessor::OCRProcessor() {
-    api = new tesseract::TessBaseAPI();
-
-    // Initialize tesseract-ocr with English
-    if (api->Init(NULL, "eng", tesseract::OEM_LSTM_ONLY)) {
-        // Could not initialize API
-        throw std::runtime_error("Failed to initialize API.");
+OCRProcessor::OCRProcessor(const std::vector<EngineProfile>& engineProfiles, int initialProfile, const std::string& tessdataDir)
+    : profiles(engineProfiles), activeProfile(-1), api(nullptr), pooledPix(nullptr) {
+    if (profiles.empty())
+        throw std::runtime_error("No OCR profiles configured.");
+
+    for (const EngineProfile& profile : profiles) {
+        if (engines.count(profile.language))
+            continue;
+
+        tesseract::TessBaseAPI* engine = new tesseract::TessBaseAPI();
+        engines[profile.language] = engine;
+
+        // Initialize tesseract-ocr with the profile's language
+        if (engine->Init(tessdataDir.empty() ? NULL : tessdataDir.c_str(), profile.language.c_str(), tesseract::OEM_LSTM_ONLY)) {
+            // Could not initialize API
+            releaseEngines();
+            throw std::runtime_error("Failed to initialize API for language '" + profile.language + "'.");
+        }
     }
-    api->SetVariable("tessedit_char_whitelist", "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890!@#$%^&*()-_=+[{]};:'\",<.>/?\\|`~");
-    api->SetVariable("tessedit_enable_dict_correction", "0");
-    api->SetPageSegMode(tesseract::PSM_SINGLE_BLOCK);
+
+    bool validProfile = initialProfile >= 0 && initialProfile < static_cast<int>(profiles.size());
+    setProfile(validProfile ? initialProfile : 0);
 }
 
 OCRProcessor::~OCRProcessor() {
-    // Destroy used object and release memory
-    api->End();
-    delete api;
+    // Destroy used objects and release memory
+    releaseEngines();
+
+    if (pooledPix)
+        pixDestroy(&pooledPix);
 }
 
+void OCRProcessor::setProfile(int index) {
+    if (index < 0 || index >= static_cast<int>(profiles.size()) || index == activeProfile)
+        return;
 
-std::string OCRProcessor::performOCR(HBITMAP hBitmap) {
-    std::string outText;
+    // Everything was resolved when the settings were loaded, this only
+    // copies a few values into the already initialized engine
+    const EngineProfile& profile = profiles[index];
+    api = engines[profile.language];
+    for (const auto& variable : profile.variables)
+        api->SetVariable(variable.first.c_str(), variable.second.c_str());
+    api->SetPageSegMode(static_cast<tesseract::PageSegMode>(profile.pageSegMode));
 
-    // Set image data
-    Pix* image = ConvertHBITMAPToPIX(hBitmap);
-    api->SetImage(image);
+    activeProfile = index;
+}
+
+int OCRProcessor::getProfile() const {
+    return activeProfile;
+}
+
+void OCRProcessor::releaseEngines() {
+    for (auto& engine : engines) {
+        engine.second->End();
+        delete engine.second;
+    }
+    engines.clear();
+    api = nullptr;
+}
+
+
+std::string OCRProcessor::performOCR(const uint8_t* bgraPixels, int width, int height, int stride) {
+    if (!bgraPixels || width <= 0 || height <= 0)
+        return std::string();
+
+    if (!pooledPix || pixGetWidth(pooledPix) != width || pixGetHeight(pooledPix) != height) {
+        if (pooledPix)
+            pixDestroy(&pooledPix);
+        pooledPix = pixCreate(width, height, 32);
+        if (!pooledPix)
+            return std::string();
+    }
+
+    // A little-endian BGRA pixel reads as 0xAARRGGBB, leptonica wants 0xRRGGBBAA
+    l_uint32* dst = pixGetData(pooledPix);
+    int wpl = pixGetWpl(pooledPix);
+    for (int y = 0; y < height; ++y) {
+        const uint32_t* srcRow = reinterpret_cast<const uint32_t*>(bgraPixels + static_cast<size_t>(y) * stride);
+        l_uint32* dstRow = dst + static_cast<size_t>(y) * wpl;
+        for (int x = 0; x < width; ++x)
+            dstRow[x] = srcRow[x] << 8;
+    }
+
+    return performOCR(pooledPix);
+}
+
+std::string OCRProcessor::performOCR(PIX* image) {
+    if (!image)
+        return std::string();
+
+    PIX* prepared = preprocess(image);
+    if (!prepared)
+        return std::string();
+    api->SetImage(prepared);
 
     // Get OCR result
-    outText = api->GetUTF8Text();
+    char* text = api->GetUTF8Text();
+    std::string outText = text ? text : "";
+    delete[] text;
+
+    pixDestroy(&prepared);
+
+    return outText;
+}
+
+PIX* OCRProcessor::preprocess(PIX* image) const {
+    PIX* current = pixClone(image);
+
+    for (PreprocessStep step : profiles[activeProfile].preprocess) {
+        PIX* next = nullptr;
+        switch (step) {
+        case PreprocessStep::Grayscale:
+            next = pixGetDepth(current) == 32 ? pixConvertRGBToLuminance(current) : pixClone(current);
+            break;
+        case PreprocessStep::Invert:
+            next = pixInvert(NULL, current);
+            break;
+        case PreprocessStep::Upscale:
+            next = pixScale(current, 2.0f, 2.0f);
+            break;
+        case PreprocessStep::Binarize:
+            next = pixConvertTo1(current, 128);
+            break;
+        }
+
+        pixDestroy(&current);
+        if (!next)
+            return nullptr;
+        current = next;
+    }
+
+    return current;
+}
+
+#ifdef _WIN32
+std::string OCRProcessor::performOCR(HBITMAP hBitmap) {
+    // Set image data
+    Pix* image = ConvertHBITMAPToPIX(hBitmap);
+    std::string outText = performOCR(image);
 
     pixDestroy(&image);
 
@@ -98,3 +208,4 @@ PIX* OCRProcessor::ConvertHBITMAPToPIX(HBITMAP hBitmap) {
     DeleteObject(hDib);
     return pix;
 }
+#endif
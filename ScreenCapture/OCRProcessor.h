@@ -1,20 +1,49 @@
 #pragma once
 
+#ifdef _WIN32
 #include <Windows.h>
+#endif
 #include <leptonica/allheaders.h>
 #include <tesseract/baseapi.h>
+#include <cstdint>
+#include <map>
 #include <stdexcept>
 #include <string>
+#include <vector>
+#include "Settings.h"
 
 class OCRProcessor
 {
 public:
-    OCRProcessor();
+    // Initializes one engine per language used by the profiles, so switching
+    // profiles later never re-initializes tesseract. An empty tessdataDir
+    // lets tesseract pick its default location.
+    OCRProcessor(const std::vector<EngineProfile>& engineProfiles, int initialProfile, const std::string& tessdataDir = std::string());
     ~OCRProcessor();
 
+    OCRProcessor(const OCRProcessor&) = delete;
+    OCRProcessor& operator=(const OCRProcessor&) = delete;
+
+    void setProfile(int index);
+    int getProfile() const;
+
+    // OCR on a leptonica image with the active profile, e.g. a fixture
+    // loaded with pixRead. The image is not modified or destroyed.
+    std::string performOCR(PIX* image);
+    // OCR on raw top-down BGRA pixels, e.g. a CaptureFrame
+    std::string performOCR(const uint8_t* bgraPixels, int width, int height, int stride);
+#ifdef _WIN32
     std::string performOCR(HBITMAP hBitmap);
     PIX* ConvertHBITMAPToPIX(HBITMAP hBitmap);
+#endif
 
 private:
-    tesseract::TessBaseAPI* api;
+    PIX* preprocess(PIX* image) const;
+    void releaseEngines();
+
+    std::vector<EngineProfile> profiles;
+    std::map<std::string, tesseract::TessBaseAPI*> engines;    // By language
+    int activeProfile;
+    tesseract::TessBaseAPI* api;    // Engine of the active profile
+    PIX* pooledPix;     // Reused between raw-pixel OCR calls of the same size
 };
@@ -0,0 +1,31 @@
+// RegionCache.cpp
+#include "RegionCache.h"
+
+RegionCache::RegionCache()
+    : lastMonitorKey(0)
+{
+}
+
+void RegionCache::remember(uintptr_t monitorKey, const Region& region)
+{
+    if (region.isEmpty())
+        return;
+
+    regions[monitorKey] = region;
+    lastMonitorKey = monitorKey;
+}
+
+bool RegionCache::lookup(uintptr_t monitorKey, Region& region) const
+{
+    auto it = regions.find(monitorKey);
+    if (it == regions.end())
+        return false;
+
+    region = it->second;
+    return true;
+}
+
+bool RegionCache::mostRecent(Region& region) const
+{
+    return lookup(lastMonitorKey, region);
+}
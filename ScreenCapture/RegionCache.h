@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+// Screen-space rectangle, independent of any platform rect type.
+struct Region
+{
+    int x;
+    int y;
+    int width;
+    int height;
+
+    bool isEmpty() const { return width <= 0 || height <= 0; }
+};
+
+// Remembers the last selected region per monitor, so a repeat capture can
+// skip the overlay entirely. Monitors are identified by an opaque key
+// (an HMONITOR on Windows).
+class RegionCache
+{
+public:
+    RegionCache();
+
+    void remember(uintptr_t monitorKey, const Region& region);
+    // Region last selected on the given monitor
+    bool lookup(uintptr_t monitorKey, Region& region) const;
+    // Region selected most recently on any monitor
+    bool mostRecent(Region& region) const;
+
+private:
+    std::unordered_map<uintptr_t, Region> regions;
+    uintptr_t lastMonitorKey;
+};
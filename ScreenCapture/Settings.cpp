@@ -0,0 +1,626 @@
+// Settings.cpp
+#include "Settings.h"
+
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    const char* const WhitelistVariable = "tessedit_char_whitelist";
+    const char* const BlacklistVariable = "tessedit_char_blacklist";
+    const char* const DictionaryVariable = "tessedit_enable_dict_correction";
+    const char* const ProfileSectionPrefix = "profile:";
+
+    const int MaxBorderWidth = 64;
+    const int MaxPageSegMode = 13;     // tesseract::PSM_RAW_LINE
+
+    // Hotkey actions configurable in the [hotkeys] section
+    struct HotkeySlot
+    {
+        const char* key;
+        HotkeyAction action;
+        bool onlyWhileOverlay;
+    };
+
+    const HotkeySlot hotkeySlots[] = {
+        { "capture", HotkeyAction::Capture, false },
+        { "repeatLastRegion", HotkeyAction::RepeatLastRegion, false },
+        { "toggleWatch", HotkeyAction::ToggleWatch, false },
+        { "cancel", HotkeyAction::Cancel, true },
+    };
+
+    const uint32_t KeyPrintScreen = 0x2C;
+
+    struct NamedKey
+    {
+        const char* name;
+        uint32_t keyCode;
+    };
+
+    // Virtual-key codes of the named keys
+    const NamedKey namedKeys[] = {
+        { "Esc", 0x1B }, { "Space", 0x20 }, { "Tab", 0x09 }, { "Enter", 0x0D },
+        { "PrintScreen", KeyPrintScreen }, { "Insert", 0x2D }, { "Delete", 0x2E },
+        { "Home", 0x24 }, { "End", 0x23 }, { "PageUp", 0x21 }, { "PageDown", 0x22 },
+    };
+
+    const uint32_t KeyF1 = 0x70;
+
+    // Keys that are rarely typed, so a global hotkey may use them alone
+    bool isStandaloneKey(uint32_t keyCode)
+    {
+        return keyCode == KeyPrintScreen || (keyCode >= KeyF1 && keyCode < KeyF1 + 24);
+    }
+
+    // Source form of a profile, before it is compiled
+    struct ProfileSource
+    {
+        std::string name;
+        std::string language = "eng";
+        int pageSegMode = 6;            // tesseract::PSM_SINGLE_BLOCK
+        std::string whitelist;
+        std::string blacklist;
+        bool dictionary = false;
+        std::vector<PreprocessStep> preprocess;
+        int sourceLine = 0;
+    };
+
+    std::string trim(const std::string& text)
+    {
+        size_t first = text.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos)
+            return std::string();
+        size_t last = text.find_last_not_of(" \t\r\n");
+        return text.substr(first, last - first + 1);
+    }
+
+    std::runtime_error settingsError(int lineNumber, const std::string& message)
+    {
+        return std::runtime_error("settings line " + std::to_string(lineNumber) + ": " + message);
+    }
+
+    int parseInt(const std::string& value, int minValue, int maxValue, int lineNumber)
+    {
+        size_t used = 0;
+        int result = 0;
+        try {
+            result = std::stoi(value, &used);
+        }
+        catch (const std::exception&) {
+            used = 0;
+        }
+        if (used == 0 || used != value.size() || result < minValue || result > maxValue)
+            throw settingsError(lineNumber, "expected a number between " + std::to_string(minValue) + " and " + std::to_string(maxValue) + ", got '" + value + "'");
+        return result;
+    }
+
+    bool parseBool(const std::string& value, int lineNumber)
+    {
+        if (value == "1" || value == "true")
+            return true;
+        if (value == "0" || value == "false")
+            return false;
+        throw settingsError(lineNumber, "expected 0/1 or true/false, got '" + value + "'");
+    }
+
+    ColorARGB parseColor(const std::string& value, int lineNumber)
+    {
+        int channels[4];
+        std::istringstream input(value);
+        std::string part;
+        int count = 0;
+        while (std::getline(input, part, ','))
+        {
+            if (count == 4)
+                throw settingsError(lineNumber, "expected alpha,red,green,blue, got '" + value + "'");
+            channels[count++] = parseInt(trim(part), 0, 255, lineNumber);
+        }
+        if (count != 4)
+            throw settingsError(lineNumber, "expected alpha,red,green,blue, got '" + value + "'");
+
+        return { static_cast<uint8_t>(channels[0]), static_cast<uint8_t>(channels[1]),
+                 static_cast<uint8_t>(channels[2]), static_cast<uint8_t>(channels[3]) };
+    }
+
+    const char* preprocessName(PreprocessStep step)
+    {
+        switch (step)
+        {
+        case PreprocessStep::Grayscale: return "gray";
+        case PreprocessStep::Invert:    return "invert";
+        case PreprocessStep::Upscale:   return "upscale";
+        case PreprocessStep::Binarize:  return "binarize";
+        }
+        return "";
+    }
+
+    std::vector<PreprocessStep> parsePreprocess(const std::string& value, int lineNumber)
+    {
+        const PreprocessStep steps[] = { PreprocessStep::Grayscale, PreprocessStep::Invert, PreprocessStep::Upscale, PreprocessStep::Binarize };
+
+        std::vector<PreprocessStep> result;
+        std::istringstream input(value);
+        std::string part;
+        while (std::getline(input, part, ','))
+        {
+            part = trim(part);
+            if (part.empty())
+                continue;
+
+            bool known = false;
+            for (PreprocessStep step : steps)
+            {
+                if (part == preprocessName(step))
+                {
+                    result.push_back(step);
+                    known = true;
+                    break;
+                }
+            }
+            if (!known)
+                throw settingsError(lineNumber, "unknown preprocess step '" + part + "'");
+        }
+        return result;
+    }
+
+    bool equalsIgnoreCase(const std::string& left, const std::string& right)
+    {
+        if (left.size() != right.size())
+            return false;
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            if (std::tolower(static_cast<unsigned char>(left[i])) != std::tolower(static_cast<unsigned char>(right[i])))
+                return false;
+        }
+        return true;
+    }
+
+    uint32_t parseKeyName(const std::string& name)
+    {
+        if (name.size() == 1 && std::isalnum(static_cast<unsigned char>(name[0])))
+            return static_cast<uint32_t>(std::toupper(static_cast<unsigned char>(name[0])));
+
+        for (const NamedKey& key : namedKeys)
+        {
+            if (equalsIgnoreCase(name, key.name))
+                return key.keyCode;
+        }
+        if (equalsIgnoreCase(name, "Escape"))
+            return 0x1B;
+
+        if (name.size() >= 2 && name.size() <= 3 && (name[0] == 'F' || name[0] == 'f') && name.find_first_not_of("0123456789", 1) == std::string::npos)
+        {
+            int number = std::stoi(name.substr(1));
+            if (number >= 1 && number <= 24)
+                return KeyF1 + static_cast<uint32_t>(number - 1);
+        }
+        return 0;
+    }
+
+    std::string formatKeyName(uint32_t keyCode)
+    {
+        if ((keyCode >= 'A' && keyCode <= 'Z') || (keyCode >= '0' && keyCode <= '9'))
+            return std::string(1, static_cast<char>(keyCode));
+        if (keyCode >= KeyF1 && keyCode < KeyF1 + 24)
+            return "F" + std::to_string(keyCode - KeyF1 + 1);
+        for (const NamedKey& key : namedKeys)
+        {
+            if (key.keyCode == keyCode)
+                return key.name;
+        }
+        return std::string();
+    }
+
+    // "Ctrl+Win+S" style combination, empty disables the hotkey
+    bool parseHotkey(const std::string& value, const HotkeySlot& slot, Hotkey& hotkey, int lineNumber)
+    {
+        if (value.empty())
+            return false;
+
+        hotkey = { slot.action, ModNone, 0, slot.onlyWhileOverlay };
+        std::istringstream input(value);
+        std::string part;
+        while (std::getline(input, part, '+'))
+        {
+            part = trim(part);
+            if (equalsIgnoreCase(part, "Ctrl") || equalsIgnoreCase(part, "Control"))
+                hotkey.modifiers |= ModControl;
+            else if (equalsIgnoreCase(part, "Shift"))
+                hotkey.modifiers |= ModShift;
+            else if (equalsIgnoreCase(part, "Alt"))
+                hotkey.modifiers |= ModAlt;
+            else if (equalsIgnoreCase(part, "Win"))
+                hotkey.modifiers |= ModWin;
+            else
+            {
+                uint32_t keyCode = parseKeyName(part);
+                if (keyCode == 0)
+                    throw settingsError(lineNumber, "unknown key '" + part + "' in hotkey '" + value + "'");
+                if (hotkey.keyCode != 0)
+                    throw settingsError(lineNumber, "hotkey '" + value + "' has more than one key");
+                hotkey.keyCode = keyCode;
+            }
+        }
+        if (hotkey.keyCode == 0)
+            throw settingsError(lineNumber, "hotkey '" + value + "' has no key");
+        // Hotkeys are swallowed system-wide, a plain letter would stop every
+        // application from receiving it
+        if (hotkey.modifiers == ModNone && !slot.onlyWhileOverlay && !isStandaloneKey(hotkey.keyCode))
+            throw settingsError(lineNumber, "hotkey '" + value + "' needs Ctrl, Shift, Alt or Win (only F1-F24 and PrintScreen work alone)");
+        return true;
+    }
+
+    std::string formatHotkey(const Hotkey& hotkey)
+    {
+        std::string text;
+        if (hotkey.modifiers & ModControl)
+            text += "Ctrl+";
+        if (hotkey.modifiers & ModShift)
+            text += "Shift+";
+        if (hotkey.modifiers & ModAlt)
+            text += "Alt+";
+        if (hotkey.modifiers & ModWin)
+            text += "Win+";
+        return text + formatKeyName(hotkey.keyCode);
+    }
+
+    EngineProfile compileProfile(const ProfileSource& source)
+    {
+        EngineProfile profile;
+        profile.name = source.name;
+        profile.language = source.language;
+        profile.pageSegMode = source.pageSegMode;
+        profile.preprocess = source.preprocess;
+        profile.sourceLine = source.sourceLine;
+
+        // Always set every variable a profile controls, so switching away
+        // from a profile never leaves its values behind
+        profile.variables = {
+            { WhitelistVariable, source.whitelist },
+            { BlacklistVariable, source.blacklist },
+            { DictionaryVariable, source.dictionary ? "1" : "0" },
+        };
+        return profile;
+    }
+
+    std::string variableValue(const EngineProfile& profile, const char* name)
+    {
+        for (const auto& variable : profile.variables)
+        {
+            if (variable.first == name)
+                return variable.second;
+        }
+        return std::string();
+    }
+
+    std::string formatColor(const ColorARGB& color)
+    {
+        return std::to_string(color.a) + "," + std::to_string(color.r) + "," + std::to_string(color.g) + "," + std::to_string(color.b);
+    }
+}
+
+Settings Settings::defaults()
+{
+    Settings settings;
+    settings.borderWidth = 2;
+    settings.overlayColor = { 156, 0, 0, 0 };
+    settings.borderColor = { 240, 255, 255, 255 };
+    settings.activeProfile = "code";
+    settings.hotkeys = {
+        { HotkeyAction::Capture, ModControl | ModWin, 'S', false },
+        { HotkeyAction::RepeatLastRegion, ModControl | ModWin, 'R', false },
+        { HotkeyAction::ToggleWatch, ModControl | ModWin, 'W', false },
+        { HotkeyAction::Cancel, ModNone, 0x1B, true },
+    };
+
+    ProfileSource code;
+    code.name = "code";
+    code.whitelist = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890!@#$%^&*()-_=+[{]};:'\",<.>/?\\|`~";
+
+    ProfileSource numbers;
+    numbers.name = "numbers only";
+    numbers.whitelist = "0123456789.,-+";
+    numbers.preprocess = { PreprocessStep::Grayscale, PreprocessStep::Upscale };
+
+    ProfileSource prose;
+    prose.name = "prose";
+    prose.pageSegMode = 3;              // tesseract::PSM_AUTO
+    prose.dictionary = true;
+
+    settings.profiles = { compileProfile(code), compileProfile(numbers), compileProfile(prose) };
+    return settings;
+}
+
+Settings Settings::parse(std::istream& input)
+{
+    Settings settings = defaults();
+    std::vector<ProfileSource> sources;
+    std::string section;
+    std::string line;
+    int lineNumber = 0;
+    int activeProfileLine = 0;      // 0 while activeProfile is not set in the file
+
+    while (std::getline(input, line))
+    {
+        ++lineNumber;
+        line = trim(line);
+        if (line.empty() || line[0] == ';' || line[0] == '#')
+            continue;
+
+        if (line.front() == '[')
+        {
+            if (line.back() != ']')
+                throw settingsError(lineNumber, "unterminated section header");
+            section = trim(line.substr(1, line.size() - 2));
+
+            if (section.rfind(ProfileSectionPrefix, 0) == 0)
+            {
+                ProfileSource source;
+                source.name = trim(section.substr(std::string(ProfileSectionPrefix).size()));
+                source.sourceLine = lineNumber;
+                if (source.name.empty())
+                    throw settingsError(lineNumber, "profile without a name");
+                for (const ProfileSource& existing : sources)
+                {
+                    if (existing.name == source.name)
+                        throw settingsError(lineNumber, "duplicate profile '" + source.name + "'");
+                }
+                sources.push_back(source);
+            }
+            else if (section != "general" && section != "hotkeys")
+            {
+                throw settingsError(lineNumber, "unknown section '" + section + "'");
+            }
+            continue;
+        }
+
+        size_t separator = line.find('=');
+        if (separator == std::string::npos)
+            throw settingsError(lineNumber, "expected key=value");
+        std::string key = trim(line.substr(0, separator));
+        std::string value = trim(line.substr(separator + 1));
+
+        if (section == "general")
+        {
+            if (key == "borderWidth")
+                settings.borderWidth = parseInt(value, 0, MaxBorderWidth, lineNumber);
+            else if (key == "overlayColor")
+                settings.overlayColor = parseColor(value, lineNumber);
+            else if (key == "borderColor")
+                settings.borderColor = parseColor(value, lineNumber);
+            else if (key == "activeProfile")
+            {
+                settings.activeProfile = value;
+                activeProfileLine = lineNumber;
+            }
+            else
+                throw settingsError(lineNumber, "unknown key '" + key + "'");
+        }
+        else if (section == "hotkeys")
+        {
+            const HotkeySlot* slot = nullptr;
+            for (const HotkeySlot& candidate : hotkeySlots)
+            {
+                if (key == candidate.key)
+                    slot = &candidate;
+            }
+            if (!slot)
+                throw settingsError(lineNumber, "unknown hotkey '" + key + "'");
+
+            // Replace the default binding of this action
+            for (size_t i = 0; i < settings.hotkeys.size(); ++i)
+            {
+                if (settings.hotkeys[i].action == slot->action)
+                {
+                    settings.hotkeys.erase(settings.hotkeys.begin() + i);
+                    break;
+                }
+            }
+
+            Hotkey hotkey;
+            if (parseHotkey(value, *slot, hotkey, lineNumber))
+                settings.hotkeys.push_back(hotkey);
+        }
+        else if (!section.empty())
+        {
+            ProfileSource& source = sources.back();
+            if (key == "language")
+            {
+                if (value.empty())
+                    throw settingsError(lineNumber, "empty language");
+                source.language = value;
+                source.sourceLine = lineNumber;
+            }
+            else if (key == "psm")
+                source.pageSegMode = parseInt(value, 0, MaxPageSegMode, lineNumber);
+            else if (key == "whitelist")
+                source.whitelist = value;
+            else if (key == "blacklist")
+                source.blacklist = value;
+            else if (key == "dictionary")
+                source.dictionary = parseBool(value, lineNumber);
+            else if (key == "preprocess")
+                source.preprocess = parsePreprocess(value, lineNumber);
+            else
+                throw settingsError(lineNumber, "unknown key '" + key + "'");
+        }
+        else
+        {
+            throw settingsError(lineNumber, "key outside of a section");
+        }
+    }
+
+    for (size_t i = 0; i < settings.hotkeys.size(); ++i)
+    {
+        for (size_t j = i + 1; j < settings.hotkeys.size(); ++j)
+        {
+            const Hotkey& first = settings.hotkeys[i];
+            const Hotkey& second = settings.hotkeys[j];
+            if (first.keyCode == second.keyCode && first.modifiers == second.modifiers)
+                throw std::runtime_error("settings: hotkey '" + formatHotkey(first) + "' is bound to more than one action");
+        }
+    }
+
+    if (!sources.empty())
+    {
+        settings.profiles.clear();
+        for (const ProfileSource& source : sources)
+            settings.profiles.push_back(compileProfile(source));
+    }
+
+    // Without an explicit choice the first profile of the file is active
+    if (activeProfileLine == 0)
+        settings.activeProfile = settings.profiles.front().name;
+    else if (settings.findProfile(settings.activeProfile) < 0)
+        throw settingsError(activeProfileLine, "active profile '" + settings.activeProfile + "' does not exist");
+
+    return settings;
+}
+
+Settings Settings::load(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("settings: cannot open '" + path + "'");
+    return parse(file);
+}
+
+void Settings::save(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("settings: cannot write '" + path + "'");
+
+    file << "[general]\n"
+         << "borderWidth=" << borderWidth << "\n"
+         << "overlayColor=" << formatColor(overlayColor) << "\n"
+         << "borderColor=" << formatColor(borderColor) << "\n"
+         << "activeProfile=" << activeProfile << "\n";
+
+    file << "\n[hotkeys]\n";
+    for (const HotkeySlot& slot : hotkeySlots)
+    {
+        file << slot.key << "=";
+        for (const Hotkey& hotkey : hotkeys)
+        {
+            if (hotkey.action == slot.action)
+                file << formatHotkey(hotkey);
+        }
+        file << "\n";
+    }
+
+    for (const EngineProfile& profile : profiles)
+    {
+        file << "\n[" << ProfileSectionPrefix << profile.name << "]\n"
+             << "language=" << profile.language << "\n"
+             << "psm=" << profile.pageSegMode << "\n"
+             << "whitelist=" << variableValue(profile, WhitelistVariable) << "\n"
+             << "blacklist=" << variableValue(profile, BlacklistVariable) << "\n"
+             << "dictionary=" << variableValue(profile, DictionaryVariable) << "\n"
+             << "preprocess=";
+        for (size_t i = 0; i < profile.preprocess.size(); ++i)
+            file << (i > 0 ? "," : "") << preprocessName(profile.preprocess[i]);
+        file << "\n";
+    }
+
+    if (!file)
+        throw std::runtime_error("settings: failed writing '" + path + "'");
+}
+
+void Settings::saveActiveProfile(const std::string& path, const std::string& profileName)
+{
+    // Binary on both ends, so the line endings survive unchanged: text mode
+    // would strip the '\r' on Windows and the file would come back as LF
+    std::vector<std::string> lines;
+    {
+        std::ifstream input(path, std::ios::binary);
+        if (!input)
+            throw std::runtime_error("settings: cannot open '" + path + "'");
+        std::string line;
+        while (std::getline(input, line))
+            lines.push_back(line);
+    }
+
+    // Keep Windows line endings if the file has them
+    bool crlf = !lines.empty() && !lines[0].empty() && lines[0].back() == '\r';
+    std::string newLine = "activeProfile=" + profileName + (crlf ? "\r" : "");
+
+    std::string section;
+    size_t generalHeader = lines.size();
+    bool replaced = false;
+    for (size_t i = 0; i < lines.size() && !replaced; ++i)
+    {
+        std::string line = trim(lines[i]);
+        if (!line.empty() && line.front() == '[' && line.back() == ']')
+        {
+            section = trim(line.substr(1, line.size() - 2));
+            if (section == "general" && generalHeader == lines.size())
+                generalHeader = i;
+            continue;
+        }
+
+        size_t separator = line.find('=');
+        if (section == "general" && separator != std::string::npos && trim(line.substr(0, separator)) == "activeProfile")
+        {
+            lines[i] = newLine;
+            replaced = true;
+        }
+    }
+
+    if (!replaced)
+    {
+        if (generalHeader < lines.size())
+        {
+            lines.insert(lines.begin() + generalHeader + 1, newLine);
+        }
+        else
+        {
+            lines.insert(lines.begin(), { std::string("[general]") + (crlf ? "\r" : ""), newLine, crlf ? "\r" : "" });
+        }
+    }
+
+    std::ofstream output(path, std::ios::trunc | std::ios::binary);
+    if (!output)
+        throw std::runtime_error("settings: cannot write '" + path + "'");
+    for (const std::string& line : lines)
+        output << line << "\n";
+    if (!output)
+        throw std::runtime_error("settings: failed writing '" + path + "'");
+}
+
+void Settings::validateLanguages(const std::string& tessdataDir) const
+{
+    for (const EngineProfile& profile : profiles)
+    {
+        std::istringstream input(profile.language);
+        std::string language;
+        while (std::getline(input, language, '+'))
+        {
+            std::string path = tessdataDir + "/" + language + ".traineddata";
+            if (std::ifstream(path))
+                continue;
+
+            std::string message = "profile '" + profile.name + "': language '" + language + "' has no " + path;
+            if (profile.sourceLine > 0)
+                throw settingsError(profile.sourceLine, message);
+            throw std::runtime_error("settings: " + message);
+        }
+    }
+}
+
+int Settings::findProfile(const std::string& name) const
+{
+    for (size_t i = 0; i < profiles.size(); ++i)
+    {
+        if (profiles[i].name == name)
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+int Settings::activeProfileIndex() const
+{
+    return findProfile(activeProfile);
+}
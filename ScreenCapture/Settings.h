@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "HotkeyDispatcher.h"
+
+// Image operations applied before recognition, in order.
+enum class PreprocessStep
+{
+    Grayscale,
+    Invert,
+    Upscale,    // 2x, helps with small UI fonts
+    Binarize,
+};
+
+// A profile compiled into everything OCRProcessor needs: the tesseract
+// variables are fully resolved (including resets of unused ones), so
+// switching profiles is just applying this list.
+struct EngineProfile
+{
+    std::string name;
+    std::string language;
+    int pageSegMode;
+    std::vector<std::pair<std::string, std::string>> variables;
+    std::vector<PreprocessStep> preprocess;
+    int sourceLine;     // Line defining the language, 0 for built-in profiles
+};
+
+struct ColorARGB
+{
+    uint8_t a;
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+};
+
+// Application settings, stored as an INI file:
+//
+//   [general]
+//   borderWidth=2
+//   overlayColor=156,0,0,0
+//   borderColor=240,255,255,255
+//   activeProfile=code
+//
+//   [hotkeys]
+//   capture=Ctrl+Win+S
+//   repeatLastRegion=Ctrl+Win+R
+//   toggleWatch=Ctrl+Win+W
+//   cancel=Esc
+//
+//   [profile:code]
+//   language=eng
+//   psm=6
+//   whitelist=abc...
+//   blacklist=
+//   dictionary=0
+//   preprocess=gray,upscale
+//
+// Colors are alpha,red,green,blue. Preprocess steps are gray, invert,
+// upscale and binarize. Hotkeys combine Ctrl, Shift, Alt and Win with one
+// key (A-Z, 0-9, F1-F24, Esc, Space, Tab, Enter, PrintScreen, Insert, Delete,
+// Home, End, PageUp, PageDown); an empty value disables the hotkey. Except
+// for cancel, only F1-F24 and PrintScreen may be used without a modifier.
+// Comments start with ';' or '#' on their own line.
+// Without any [profile:...] section the built-in profiles are kept. Without
+// activeProfile the first profile is active.
+struct Settings
+{
+    int borderWidth;
+    ColorARGB overlayColor;
+    ColorARGB borderColor;
+    std::string activeProfile;
+    std::vector<Hotkey> hotkeys;
+    std::vector<EngineProfile> profiles;
+
+    // Built-in settings, matching the historic hardcoded behaviour
+    static Settings defaults();
+
+    // Parse and validate, throws std::runtime_error describing the first problem
+    static Settings parse(std::istream& input);
+    static Settings load(const std::string& path);
+    // Write the whole file, used to create it on first run
+    void save(const std::string& path) const;
+    // Change only the activeProfile line of an existing file, keeping
+    // everything else (including comments) as the user wrote it
+    static void saveActiveProfile(const std::string& path, const std::string& profileName);
+
+    // Check that every profile language ("eng", "eng+deu", ...) has its
+    // traineddata in the tessdata directory, throws like parse
+    void validateLanguages(const std::string& tessdataDir) const;
+
+    // Index of the named profile, -1 if there is none
+    int findProfile(const std::string& name) const;
+    int activeProfileIndex() const;
+};
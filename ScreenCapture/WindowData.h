@@ -2,6 +2,9 @@
 
 #include <Windows.h>
 #include "OCRProcessor.h"
+#include "CaptureSource.h"
+#include "RegionCache.h"
+#include <string>
 
 struct WindowData
 {
@@ -10,6 +13,13 @@ struct WindowData
     HBITMAP memoryBitmap;
     int windowWidth;
     int windowHeight;
+    int originX;        // Virtual screen position of the overlay's top-left corner,
+    int originY;        // negative when a monitor is left of or above the primary one
     OCRProcessor* ocr;
     bool isWindowVisible;
+    CaptureSource* captureSource;   // Region captures into a pooled buffer
+    RegionCache* lastRegions;       // Last selected region per monitor
+    Region watchRegion;             // Region re-captured by watch mode
+    bool isWatching;
+    std::string lastOcrText;        // Last text copied by watch mode
 };
\ No newline at end of file
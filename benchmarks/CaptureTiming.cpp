@@ -0,0 +1,63 @@
+// CaptureTiming.cpp
+//
+// Times repeated captures of the same region, the path repeat-last-region
+// and watch mode take, with an image file standing in for the screen:
+//   CaptureTiming <image> [tessdata directory] [iterations]
+// Each iteration captures into the pooled buffer and recognizes it with
+// the default active profile.
+#include "FileCaptureSource.h"
+#include "LatencyStats.h"
+#include "OCRProcessor.h"
+#include "Settings.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s <image> [tessdata directory] [iterations]\n", argv[0]);
+        return 2;
+    }
+    std::string tessdataDir = argc > 2 ? argv[2] : std::string();
+    int iterations = argc > 3 ? std::atoi(argv[3]) : 50;
+
+    try {
+        FileCaptureSource source(argv[1]);
+        Settings settings = Settings::defaults();
+        OCRProcessor ocr(settings.profiles, settings.activeProfileIndex(), tessdataDir);
+
+        Region region = { 0, 0, source.getWidth(), source.getHeight() };
+        LatencyStats captureLatency;
+        LatencyStats recognizeLatency;
+        std::string text;
+        for (int i = 0; i < iterations; ++i)
+        {
+            CaptureFrame frame;
+            {
+                ScopedLatency timing(captureLatency);
+                if (!source.capture(region, frame))
+                    throw std::runtime_error("capture failed");
+            }
+            {
+                ScopedLatency timing(recognizeLatency);
+                text = ocr.performOCR(frame.pixels, frame.width, frame.height, frame.stride);
+            }
+        }
+
+        std::printf("region    %dx%d\n", region.width, region.height);
+        std::printf("capture   %s\n", captureLatency.summary().c_str());
+        std::printf("recognize %s\n", recognizeLatency.summary().c_str());
+        std::printf("text      %zu bytes\n", text.size());
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
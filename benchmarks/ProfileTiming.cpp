@@ -0,0 +1,87 @@
+// ProfileTiming.cpp
+//
+// Times the parts of the cold start and of a profile switch:
+//   ProfileTiming [settings.ini] [tessdata directory]
+// Without a settings file the defaults are written to a temporary one.
+#include "LatencyStats.h"
+#include "Settings.h"
+#ifdef SCREENCAPTURE_HAVE_OCR
+#include "OCRProcessor.h"
+#endif
+
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace
+{
+    const int LoadIterations = 1000;
+    const int EngineIterations = 5;
+    const int SwitchIterations = 1000;
+
+    void printStats(const char* name, const LatencyStats& stats)
+    {
+        std::printf("%-16s %s\n", name, stats.summary().c_str());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string settingsPath;
+    if (argc > 1)
+    {
+        settingsPath = argv[1];
+    }
+    else
+    {
+        settingsPath = (std::filesystem::temp_directory_path() / "ProfileTiming.ini").string();
+        Settings::defaults().save(settingsPath);
+    }
+    std::string tessdataDir = argc > 2 ? argv[2] : std::string();
+
+    try {
+        LatencyStats loadLatency;
+        Settings settings;
+        for (int i = 0; i < LoadIterations; ++i)
+        {
+            ScopedLatency timing(loadLatency);
+            settings = Settings::load(settingsPath);
+        }
+        printStats("settings load", loadLatency);
+
+#ifdef SCREENCAPTURE_HAVE_OCR
+        LatencyStats engineLatency;
+        for (int i = 0; i < EngineIterations; ++i)
+        {
+            std::unique_ptr<OCRProcessor> engine;
+            {
+                ScopedLatency timing(engineLatency);
+                engine = std::make_unique<OCRProcessor>(settings.profiles, settings.activeProfileIndex(), tessdataDir);
+            }
+        }
+        printStats("engine init", engineLatency);
+
+        OCRProcessor ocr(settings.profiles, settings.activeProfileIndex(), tessdataDir);
+        LatencyStats switchLatency;
+        int profileCount = static_cast<int>(settings.profiles.size());
+        for (int i = 0; i < SwitchIterations; ++i)
+        {
+            int next = (ocr.getProfile() + 1) % profileCount;
+            ScopedLatency timing(switchLatency);
+            ocr.setProfile(next);
+        }
+        printStats("setProfile", switchLatency);
+#else
+        (void)tessdataDir;
+        std::printf("built without tesseract, engine init and setProfile are not timed\n");
+#endif
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
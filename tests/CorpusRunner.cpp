@@ -0,0 +1,341 @@
+// CorpusRunner.cpp
+//
+// OCR regression run over a versioned fixture corpus:
+//   CorpusRunner <corpus directory> <tessdata directory> [--settings file] [--jobs n] [--repeat n] [--calibrate]
+//
+// The corpus directory holds <name>.png screenshots, their golden <name>.txt
+// and manifest.tsv with the profile and thresholds of each fixture. Fixtures
+// go through the same path as a capture in the application: the pixels are
+// copied into a pooled BGRA frame and recognized with the profile compiled
+// from the settings (the built-in defaults unless --settings is given).
+//
+// Accuracy is checked on a pool of worker threads. Each worker owns its own
+// OCRProcessor, tesseract engines are not safe to share between threads.
+// Latency is timed afterwards in a separate pass on a single worker, so it
+// does not depend on --jobs. Run with OMP_THREAD_LIMIT=1 (the ocr_corpus
+// target does) so tesseract's own threads do not make it depend on the
+// core count either.
+//
+// Exits with 1 if any fixture exceeds its thresholds or fails to run.
+// --calibrate prints a manifest with the measured values plus the margins
+// below instead, for recording the thresholds of a new baseline.
+#include "FileCaptureSource.h"
+#include "LatencyStats.h"
+#include "OCRProcessor.h"
+#include "Settings.h"
+#include "TextMetrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Fixture
+    {
+        std::string name;
+        std::string profile;
+        double maxCer;
+        double maxWer;
+        double maxMilliseconds;
+    };
+
+    struct FixtureResult
+    {
+        TextErrorRates rates;
+        double milliseconds;    // Median recognition time, from the timing pass
+        std::string error;      // Set if the fixture could not be run
+        bool passed;
+    };
+
+    struct Options
+    {
+        std::string corpusDir;
+        std::string tessdataDir;
+        std::string settingsPath;
+        int jobs;
+        int repeat;
+        bool calibrate;
+    };
+
+    // Margins --calibrate adds to the measured values
+    const double CerMargin = 0.01;          // Absolute
+    const double WerMargin = 0.05;          // Absolute
+    const double LatencyFactor = 1.5;       // Relative
+    const double MinLatencyMarginMs = 10.0;
+
+    std::vector<Fixture> readManifest(const std::string& path)
+    {
+        std::ifstream file(path);
+        if (!file)
+            throw std::runtime_error("cannot open '" + path + "'");
+
+        std::vector<Fixture> fixtures;
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(file, line))
+        {
+            ++lineNumber;
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            std::vector<std::string> columns;
+            std::istringstream input(line);
+            std::string column;
+            while (std::getline(input, column, '\t'))
+                columns.push_back(column);
+            if (columns.size() != 5)
+                throw std::runtime_error(path + " line " + std::to_string(lineNumber) + ": expected 5 tab separated columns");
+
+            try {
+                fixtures.push_back({ columns[0], columns[1], std::stod(columns[2]), std::stod(columns[3]), std::stod(columns[4]) });
+            }
+            catch (const std::exception&) {
+                throw std::runtime_error(path + " line " + std::to_string(lineNumber) + ": invalid threshold");
+            }
+        }
+        return fixtures;
+    }
+
+    std::string readText(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            throw std::runtime_error("cannot open '" + path + "'");
+        std::ostringstream text;
+        text << file.rdbuf();
+        return text.str();
+    }
+
+    std::string fixtureBase(const Options& options, const Fixture& fixture)
+    {
+        return options.corpusDir + "/" + fixture.name;
+    }
+
+    void selectProfile(const Fixture& fixture, const Settings& settings, OCRProcessor& ocr)
+    {
+        int profile = settings.findProfile(fixture.profile);
+        if (profile < 0)
+            throw std::runtime_error("unknown profile '" + fixture.profile + "'");
+        ocr.setProfile(profile);
+    }
+
+    std::string recognize(FileCaptureSource& source, OCRProcessor& ocr)
+    {
+        Region region = { 0, 0, source.getWidth(), source.getHeight() };
+        CaptureFrame frame;
+        if (!source.capture(region, frame))
+            throw std::runtime_error("capture failed");
+        return ocr.performOCR(frame.pixels, frame.width, frame.height, frame.stride);
+    }
+
+    // Accuracy pass, runs on any worker
+    void checkAccuracy(const Fixture& fixture, const Options& options, const Settings& settings, OCRProcessor& ocr, FixtureResult& result)
+    {
+        try {
+            selectProfile(fixture, settings, ocr);
+            std::string golden = readText(fixtureBase(options, fixture) + ".txt");
+            FileCaptureSource source(fixtureBase(options, fixture) + ".png");
+            result.rates = compareText(golden, recognize(source, ocr));
+        }
+        catch (const std::exception& e) {
+            result.error = e.what();
+        }
+    }
+
+    // Timing pass, runs on a single worker with nothing else recognizing
+    void measureLatency(const Fixture& fixture, const Options& options, const Settings& settings, OCRProcessor& ocr, FixtureResult& result)
+    {
+        try {
+            selectProfile(fixture, settings, ocr);
+            FileCaptureSource source(fixtureBase(options, fixture) + ".png");
+
+            // The first recognition after a profile switch is not timed
+            recognize(source, ocr);
+
+            LatencyStats latency;
+            for (int i = 0; i < options.repeat; ++i)
+            {
+                ScopedLatency timing(latency);
+                recognize(source, ocr);
+            }
+            result.milliseconds = std::chrono::duration<double, std::milli>(latency.percentile(50)).count();
+        }
+        catch (const std::exception& e) {
+            result.error = e.what();
+        }
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options)
+    {
+        if (argc < 3)
+            return false;
+
+        options.corpusDir = argv[1];
+        options.tessdataDir = argv[2];
+        options.jobs = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        options.repeat = 5;
+        options.calibrate = false;
+        for (int i = 3; i < argc; ++i)
+        {
+            std::string argument = argv[i];
+            if (argument == "--calibrate")
+            {
+                options.calibrate = true;
+                continue;
+            }
+            if (i + 1 >= argc)
+                return false;
+            if (argument == "--settings")
+                options.settingsPath = argv[++i];
+            else if (argument == "--jobs")
+                options.jobs = std::max(1, std::atoi(argv[++i]));
+            else if (argument == "--repeat")
+                options.repeat = std::max(1, std::atoi(argv[++i]));
+            else
+                return false;
+        }
+        return true;
+    }
+
+    void printCalibratedManifest(const std::vector<Fixture>& fixtures, const std::vector<FixtureResult>& results)
+    {
+        std::printf("# fixture\tprofile\tmax_cer\tmax_wer\tmax_ms\n");
+        std::printf("# Measured values plus %.2f CER, %.2f WER and %.0f%% (at least %.0f ms) latency.\n",
+            CerMargin, WerMargin, (LatencyFactor - 1.0) * 100.0, MinLatencyMarginMs);
+        for (size_t i = 0; i < fixtures.size(); ++i)
+        {
+            const FixtureResult& result = results[i];
+            double maxMs = std::max(result.milliseconds * LatencyFactor, result.milliseconds + MinLatencyMarginMs);
+            std::printf("%s\t%s\t%.3f\t%.3f\t%.0f\n", fixtures[i].name.c_str(), fixtures[i].profile.c_str(),
+                result.rates.cer + CerMargin, result.rates.wer + WerMargin, std::ceil(maxMs));
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::fprintf(stderr, "usage: %s <corpus directory> <tessdata directory> [--settings file] [--jobs n] [--repeat n] [--calibrate]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<Fixture> fixtures;
+    Settings settings;
+    try {
+        fixtures = readManifest(options.corpusDir + "/manifest.tsv");
+        settings = options.settingsPath.empty() ? Settings::defaults() : Settings::load(options.settingsPath);
+        settings.validateLanguages(options.tessdataDir);
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+
+    std::vector<FixtureResult> results(fixtures.size());
+    std::atomic<size_t> nextFixture(0);
+    std::mutex engineErrorMutex;
+    std::string engineError;    // Set if any worker could not initialize tesseract
+
+    auto createEngine = [&]() {
+        std::unique_ptr<OCRProcessor> ocr;
+        try {
+            ocr = std::make_unique<OCRProcessor>(settings.profiles, settings.activeProfileIndex(), options.tessdataDir);
+        }
+        catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(engineErrorMutex);
+            engineError = e.what();
+        }
+        return ocr;
+    };
+
+    auto worker = [&]() {
+        std::unique_ptr<OCRProcessor> ocr = createEngine();
+        if (!ocr)
+            return;
+        for (size_t index = nextFixture++; index < fixtures.size(); index = nextFixture++)
+            checkAccuracy(fixtures[index], options, settings, *ocr, results[index]);
+    };
+
+    int jobs = std::min(options.jobs, static_cast<int>(std::max<size_t>(fixtures.size(), 1)));
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 1; i < jobs; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread& thread : threads)
+        thread.join();
+    double accuracySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::unique_ptr<OCRProcessor> timingEngine = createEngine();
+    if (timingEngine)
+    {
+        for (size_t i = 0; i < fixtures.size(); ++i)
+        {
+            if (results[i].error.empty())
+                measureLatency(fixtures[i], options, settings, *timingEngine, results[i]);
+        }
+    }
+
+    if (!engineError.empty())
+    {
+        std::fprintf(stderr, "failed to initialize OCR: %s\n", engineError.c_str());
+        return 1;
+    }
+
+    // With --calibrate the report goes to stderr, stdout is the new manifest
+    FILE* report = options.calibrate ? stderr : stdout;
+    int failures = 0;
+    std::fprintf(report, "%-24s %-14s %8s %8s %10s  %s\n", "fixture", "profile", "cer", "wer", "ms", "result");
+    for (size_t i = 0; i < fixtures.size(); ++i)
+    {
+        const Fixture& fixture = fixtures[i];
+        FixtureResult& result = results[i];
+        result.passed = result.error.empty() && result.rates.cer <= fixture.maxCer &&
+            result.rates.wer <= fixture.maxWer && result.milliseconds <= fixture.maxMilliseconds;
+        if (!result.passed)
+            ++failures;
+
+        if (!result.error.empty())
+        {
+            std::fprintf(report, "%-24s %-14s %8s %8s %10s  FAIL %s\n", fixture.name.c_str(), fixture.profile.c_str(), "-", "-", "-", result.error.c_str());
+            continue;
+        }
+        std::fprintf(report, "%-24s %-14s %8.4f %8.4f %10.1f  %s\n", fixture.name.c_str(), fixture.profile.c_str(),
+            result.rates.cer, result.rates.wer, result.milliseconds, result.passed ? "PASS" : "FAIL");
+        if (!result.passed)
+            std::fprintf(report, "    limits: cer %.4f, wer %.4f, %.0f ms\n", fixture.maxCer, fixture.maxWer, fixture.maxMilliseconds);
+    }
+
+    const char* ompThreadLimit = std::getenv("OMP_THREAD_LIMIT");
+    std::fprintf(report, "%zu fixtures, %d failed, accuracy on %d jobs in %.2f s, latency on 1 job, %d runs each, OMP_THREAD_LIMIT=%s\n",
+        fixtures.size(), failures, jobs, accuracySeconds, options.repeat, ompThreadLimit ? ompThreadLimit : "unset");
+
+    if (options.calibrate)
+    {
+        for (const FixtureResult& result : results)
+        {
+            if (!result.error.empty())
+                return 1;
+        }
+        printCalibratedManifest(fixtures, results);
+        return 0;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+// HotkeyDispatcherTests.cpp
+#include "HotkeyDispatcher.h"
+#include "TestCheck.h"
+
+namespace
+{
+    const uint32_t KeyEscape = 0x1B;
+
+    HotkeyDispatcher makeDispatcher()
+    {
+        HotkeyDispatcher dispatcher;
+        dispatcher.bind({ HotkeyAction::Capture, ModControl | ModWin, 'S', false });
+        dispatcher.bind({ HotkeyAction::RepeatLastRegion, ModControl | ModShift | ModWin, 'S', false });
+        dispatcher.bind({ HotkeyAction::Cancel, ModNone, KeyEscape, true });
+        return dispatcher;
+    }
+
+    // Press and release a key, returning the result of the press
+    HotkeyDispatcher::Result tap(HotkeyDispatcher& dispatcher, uint32_t keyCode)
+    {
+        HotkeyDispatcher::Result result = dispatcher.onKeyEvent(keyCode, true);
+        dispatcher.onKeyEvent(keyCode, false);
+        return result;
+    }
+}
+
+void leftAndRightModifiersAreTrackedSeparately()
+{
+    HotkeyDispatcher dispatcher = makeDispatcher();
+
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftControl, true);
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyRightControl, true);
+    CHECK(dispatcher.getModifiers() == ModControl);
+
+    // Releasing one side keeps the modifier held through the other
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftControl, false);
+    CHECK(dispatcher.getModifiers() == ModControl);
+
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyRightControl, false);
+    CHECK(dispatcher.getModifiers() == ModNone);
+
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyRightShift, true);
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftAlt, true);
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyRightWin, true);
+    CHECK(dispatcher.getModifiers() == (ModShift | ModAlt | ModWin));
+}
+
+void modifierEventsAreNeverSwallowed()
+{
+    HotkeyDispatcher dispatcher = makeDispatcher();
+
+    HotkeyDispatcher::Result down = dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftWin, true);
+    HotkeyDispatcher::Result up = dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftWin, false);
+    CHECK(down.action == HotkeyAction::None && !down.swallow);
+    CHECK(up.action == HotkeyAction::None && !up.swallow);
+}
+
+void modifiersMustMatchExactly()
+{
+    HotkeyDispatcher dispatcher = makeDispatcher();
+
+    // The trigger alone or with a subset of the modifiers passes through
+    HotkeyDispatcher::Result result = tap(dispatcher, 'S');
+    CHECK(result.action == HotkeyAction::None && !result.swallow);
+
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftControl, true);
+    result = tap(dispatcher, 'S');
+    CHECK(result.action == HotkeyAction::None && !result.swallow);
+
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftWin, true);
+    result = tap(dispatcher, 'S');
+    CHECK(result.action == HotkeyAction::Capture && result.swallow);
+
+    // An extra modifier selects the other binding
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftShift, true);
+    result = tap(dispatcher, 'S');
+    CHECK(result.action == HotkeyAction::RepeatLastRegion && result.swallow);
+
+    // And one that has no binding matches nothing
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftAlt, true);
+    result = tap(dispatcher, 'S');
+    CHECK(result.action == HotkeyAction::None && !result.swallow);
+}
+
+void triggerAutoRepeatAndReleaseAreSwallowed()
+{
+    HotkeyDispatcher dispatcher = makeDispatcher();
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftControl, true);
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftWin, true);
+
+    HotkeyDispatcher::Result result = dispatcher.onKeyEvent('S', true);
+    CHECK(result.action == HotkeyAction::Capture && result.swallow);
+
+    // Holding the key fires only once
+    for (int i = 0; i < 3; ++i)
+    {
+        result = dispatcher.onKeyEvent('S', true);
+        CHECK(result.action == HotkeyAction::None && result.swallow);
+    }
+
+    // Releasing the modifiers first still swallows the trigger's key-up
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftControl, false);
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftWin, false);
+    result = dispatcher.onKeyEvent('S', false);
+    CHECK(result.action == HotkeyAction::None && result.swallow);
+
+    // After that the key is an ordinary key again
+    result = dispatcher.onKeyEvent('S', true);
+    CHECK(result.action == HotkeyAction::None && !result.swallow);
+    result = dispatcher.onKeyEvent('S', false);
+    CHECK(!result.swallow);
+}
+
+void cancelOnlyWhileOverlayIsActive()
+{
+    HotkeyDispatcher dispatcher = makeDispatcher();
+
+    HotkeyDispatcher::Result result = tap(dispatcher, KeyEscape);
+    CHECK(result.action == HotkeyAction::None && !result.swallow);
+
+    dispatcher.setOverlayActive(true);
+    result = tap(dispatcher, KeyEscape);
+    CHECK(result.action == HotkeyAction::Cancel && result.swallow);
+
+    // Escape with a modifier is left to other applications
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftShift, true);
+    result = tap(dispatcher, KeyEscape);
+    CHECK(result.action == HotkeyAction::None && !result.swallow);
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftShift, false);
+
+    dispatcher.setOverlayActive(false);
+    result = tap(dispatcher, KeyEscape);
+    CHECK(result.action == HotkeyAction::None && !result.swallow);
+}
+
+void resetClearsStuckModifiers()
+{
+    HotkeyDispatcher dispatcher = makeDispatcher();
+
+    // Win+L: the Win key-up happens on the secure desktop and is never seen
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftWin, true);
+    dispatcher.onKeyEvent('L', true);
+    CHECK(dispatcher.getModifiers() == ModWin);
+
+    // With Win stuck, a plain Ctrl+S would be taken for the capture hotkey
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftControl, true);
+    CHECK(dispatcher.getModifiers() == (ModControl | ModWin));
+
+    dispatcher.reset();
+    CHECK(dispatcher.getModifiers() == ModNone);
+
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftControl, true);
+    HotkeyDispatcher::Result result = tap(dispatcher, 'S');
+    CHECK(result.action == HotkeyAction::None && !result.swallow);
+}
+
+void resetForgetsTheActiveTrigger()
+{
+    HotkeyDispatcher dispatcher = makeDispatcher();
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftControl, true);
+    dispatcher.onKeyEvent(HotkeyDispatcher::KeyLeftWin, true);
+    CHECK(dispatcher.onKeyEvent('S', true).action == HotkeyAction::Capture);
+
+    dispatcher.reset();
+    HotkeyDispatcher::Result result = dispatcher.onKeyEvent('S', false);
+    CHECK(!result.swallow);
+}
+
+int main()
+{
+    RUN_TEST(leftAndRightModifiersAreTrackedSeparately);
+    RUN_TEST(modifierEventsAreNeverSwallowed);
+    RUN_TEST(modifiersMustMatchExactly);
+    RUN_TEST(triggerAutoRepeatAndReleaseAreSwallowed);
+    RUN_TEST(cancelOnlyWhileOverlayIsActive);
+    RUN_TEST(resetClearsStuckModifiers);
+    RUN_TEST(resetForgetsTheActiveTrigger);
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,85 @@
+// LatencyStatsTests.cpp
+#include "LatencyStats.h"
+#include "TestCheck.h"
+
+using std::chrono::microseconds;
+
+void emptyStatsReportZero()
+{
+    LatencyStats stats(8);
+    CHECK(stats.count() == 0);
+    CHECK(stats.percentile(50) == LatencyStats::Duration::zero());
+    CHECK(stats.maximum() == LatencyStats::Duration::zero());
+}
+
+void percentilesUseNearestRank()
+{
+    LatencyStats stats(100);
+    for (int i = 100; i >= 1; --i)
+        stats.record(microseconds(i));
+
+    CHECK(stats.count() == 100);
+    CHECK(stats.percentile(0) == microseconds(1));
+    CHECK(stats.percentile(50) == microseconds(50));
+    CHECK(stats.percentile(95) == microseconds(95));
+    CHECK(stats.percentile(99) == microseconds(99));
+    CHECK(stats.percentile(100) == microseconds(100));
+    CHECK(stats.maximum() == microseconds(100));
+}
+
+void wraparoundKeepsOnlyTheNewestSamples()
+{
+    LatencyStats stats(4);
+    for (int i = 1; i <= 10; ++i)
+        stats.record(microseconds(i));
+
+    // Samples 7..10 remain
+    CHECK(stats.count() == 4);
+    CHECK(stats.percentile(0) == microseconds(7));
+    CHECK(stats.percentile(25) == microseconds(7));
+    CHECK(stats.percentile(50) == microseconds(8));
+    CHECK(stats.percentile(75) == microseconds(9));
+    CHECK(stats.percentile(100) == microseconds(10));
+    CHECK(stats.maximum() == microseconds(10));
+
+    // Exactly at the wrap point the oldest sample is replaced
+    LatencyStats exact(4);
+    for (int i = 1; i <= 5; ++i)
+        exact.record(microseconds(i * 10));
+    CHECK(exact.count() == 4);
+    CHECK(exact.percentile(0) == microseconds(20));
+    CHECK(exact.maximum() == microseconds(50));
+}
+
+void wraparoundDropsAnOldMaximum()
+{
+    LatencyStats stats(3);
+    stats.record(microseconds(1000));
+    for (int i = 0; i < 3; ++i)
+        stats.record(microseconds(5));
+
+    CHECK(stats.maximum() == microseconds(5));
+    CHECK(stats.percentile(99) == microseconds(5));
+}
+
+void clearStartsOver()
+{
+    LatencyStats stats(4);
+    stats.record(microseconds(3));
+    stats.clear();
+    CHECK(stats.count() == 0);
+
+    stats.record(microseconds(9));
+    CHECK(stats.count() == 1);
+    CHECK(stats.percentile(50) == microseconds(9));
+}
+
+int main()
+{
+    RUN_TEST(emptyStatsReportZero);
+    RUN_TEST(percentilesUseNearestRank);
+    RUN_TEST(wraparoundKeepsOnlyTheNewestSamples);
+    RUN_TEST(wraparoundDropsAnOldMaximum);
+    RUN_TEST(clearStartsOver);
+    return TEST_EXIT_CODE();
+}
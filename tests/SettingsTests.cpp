@@ -0,0 +1,342 @@
+// SettingsTests.cpp
+#include "Settings.h"
+#include "TestCheck.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    Settings parseText(const std::string& text)
+    {
+        std::istringstream input(text);
+        return Settings::parse(input);
+    }
+
+    // Message of the exception parse throws, empty if it does not throw
+    std::string parseError(const std::string& text)
+    {
+        try {
+            parseText(text);
+        }
+        catch (const std::runtime_error& e) {
+            return e.what();
+        }
+        return std::string();
+    }
+
+    bool contains(const std::string& text, const std::string& part)
+    {
+        return text.find(part) != std::string::npos;
+    }
+
+    std::string tempPath(const std::string& name)
+    {
+        return (std::filesystem::temp_directory_path() / ("SettingsTests_" + name)).string();
+    }
+
+    void writeFile(const std::string& path, const std::string& text)
+    {
+        std::ofstream file(path, std::ios::trunc | std::ios::binary);
+        file << text;
+    }
+
+    std::string readFile(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        std::ostringstream text;
+        text << file.rdbuf();
+        return text.str();
+    }
+
+    const Hotkey* findHotkey(const Settings& settings, HotkeyAction action)
+    {
+        for (const Hotkey& hotkey : settings.hotkeys)
+        {
+            if (hotkey.action == action)
+                return &hotkey;
+        }
+        return nullptr;
+    }
+}
+
+void emptyFileGivesDefaults()
+{
+    Settings settings = parseText("");
+    Settings defaults = Settings::defaults();
+
+    CHECK(settings.borderWidth == defaults.borderWidth);
+    CHECK(settings.activeProfile == "code");
+    CHECK(settings.profiles.size() == defaults.profiles.size());
+    CHECK(settings.hotkeys.size() == defaults.hotkeys.size());
+    CHECK(settings.activeProfileIndex() == 0);
+}
+
+void generalValuesAreParsed()
+{
+    Settings settings = parseText(
+        "; comment\n"
+        "[general]\r\n"
+        "borderWidth = 5\n"
+        "overlayColor=1, 2, 3, 4\n"
+        "activeProfile=prose\n");
+
+    CHECK(settings.borderWidth == 5);
+    CHECK(settings.overlayColor.a == 1 && settings.overlayColor.r == 2);
+    CHECK(settings.overlayColor.g == 3 && settings.overlayColor.b == 4);
+    CHECK(settings.activeProfile == "prose");
+    CHECK(settings.activeProfileIndex() == 2);
+}
+
+void profilesAreCompiled()
+{
+    Settings settings = parseText(
+        "[profile:digits]\n"
+        "psm=7\n"
+        "whitelist=0123456789\n"
+        "dictionary=1\n"
+        "preprocess=gray, binarize\n");
+
+    // File profiles replace the built-in ones
+    CHECK(settings.profiles.size() == 1);
+    const EngineProfile& profile = settings.profiles[0];
+    CHECK(profile.name == "digits");
+    CHECK(profile.language == "eng");
+    CHECK(profile.pageSegMode == 7);
+    CHECK(profile.preprocess.size() == 2);
+    CHECK(profile.preprocess[1] == PreprocessStep::Binarize);
+
+    // Every controlled variable is set, so switching never leaves values behind
+    bool sawWhitelist = false;
+    bool sawBlacklist = false;
+    for (const auto& variable : profile.variables)
+    {
+        if (variable.first == "tessedit_char_whitelist")
+            sawWhitelist = variable.second == "0123456789";
+        if (variable.first == "tessedit_char_blacklist")
+            sawBlacklist = variable.second.empty();
+    }
+    CHECK(sawWhitelist);
+    CHECK(sawBlacklist);
+}
+
+void missingActiveProfileUsesFirstProfile()
+{
+    Settings settings = parseText("[profile:x]\nwhitelist=abc\n[profile:y]\n");
+    CHECK(settings.activeProfile == "x");
+    CHECK(settings.activeProfileIndex() == 0);
+}
+
+void unknownActiveProfileIsRejected()
+{
+    std::string error = parseError("[general]\nactiveProfile=y\n[profile:x]\n");
+    CHECK(contains(error, "line 2"));
+    CHECK(contains(error, "'y'"));
+}
+
+void errorsReportTheLine()
+{
+    CHECK(contains(parseError("[general]\nborderWidth=65\n"), "line 2"));
+    CHECK(contains(parseError("[general]\noverlayColor=1,2,3\n"), "line 2"));
+    CHECK(contains(parseError("\n[nope]\n"), "line 2"));
+    CHECK(contains(parseError("[general\n"), "line 1"));
+    CHECK(contains(parseError("key=value\n"), "line 1"));
+    CHECK(contains(parseError("[profile:a]\npsm=14\n"), "line 2"));
+    CHECK(contains(parseError("[profile:a]\npreprocess=gray,blur\n"), "line 2"));
+    CHECK(contains(parseError("[profile:a]\n[profile:a]\n"), "line 2"));
+    CHECK(contains(parseError("[profile:a]\ndictionary=yes\n"), "line 2"));
+    CHECK(contains(parseError("[hotkeys]\ncapture=Ctrl+Hyper\n"), "line 2"));
+}
+
+void hotkeysAreParsed()
+{
+    Settings settings = parseText(
+        "[hotkeys]\n"
+        "capture=ctrl+shift+F9\n"
+        "toggleWatch=\n");
+
+    const Hotkey* capture = findHotkey(settings, HotkeyAction::Capture);
+    CHECK(capture != nullptr);
+    if (capture)
+    {
+        CHECK(capture->modifiers == (ModControl | ModShift));
+        CHECK(capture->keyCode == 0x78);
+    }
+
+    // An empty value disables the hotkey, the others keep their defaults
+    CHECK(findHotkey(settings, HotkeyAction::ToggleWatch) == nullptr);
+    const Hotkey* cancel = findHotkey(settings, HotkeyAction::Cancel);
+    CHECK(cancel != nullptr && cancel->onlyWhileOverlay);
+}
+
+void globalHotkeysNeedAModifier()
+{
+    CHECK(contains(parseError("[hotkeys]\ncapture=S\n"), "line 2"));
+    CHECK(contains(parseError("[hotkeys]\nrepeatLastRegion=Space\n"), "needs Ctrl"));
+    CHECK(contains(parseError("[hotkeys]\ntoggleWatch=Esc\n"), "needs Ctrl"));
+
+    // Keys nobody types in running text may stand alone
+    Settings settings = parseText("[hotkeys]\ncapture=PrintScreen\ntoggleWatch=F12\n");
+    const Hotkey* capture = findHotkey(settings, HotkeyAction::Capture);
+    CHECK(capture != nullptr && capture->modifiers == ModNone && capture->keyCode == 0x2C);
+    const Hotkey* toggleWatch = findHotkey(settings, HotkeyAction::ToggleWatch);
+    CHECK(toggleWatch != nullptr && toggleWatch->keyCode == 0x7B);
+
+    // Cancel only fires while the overlay is shown, so any key is fine
+    CHECK(parseError("[hotkeys]\ncancel=Q\n").empty());
+}
+
+void duplicateHotkeysAreRejected()
+{
+    CHECK(contains(parseError("[hotkeys]\ncapture=Ctrl+Win+R\n"), "more than one action"));
+    // Not a duplicate once the other binding moved away
+    CHECK(parseError("[hotkeys]\ncapture=Ctrl+Win+R\nrepeatLastRegion=Ctrl+Win+T\n").empty());
+}
+
+void saveAndLoadRoundTrip()
+{
+    Settings settings = parseText(
+        "[general]\n"
+        "borderWidth=3\n"
+        "borderColor=10,20,30,40\n"
+        "activeProfile=b\n"
+        "[hotkeys]\n"
+        "capture=Alt+PrintScreen\n"
+        "cancel=\n"
+        "[profile:a]\n"
+        "language=eng+deu\n"
+        "blacklist=|\n"
+        "[profile:b]\n"
+        "psm=11\n"
+        "dictionary=1\n"
+        "preprocess=invert,upscale\n");
+
+    std::string path = tempPath("roundtrip.ini");
+    settings.save(path);
+    Settings loaded = Settings::load(path);
+    std::filesystem::remove(path);
+
+    CHECK(loaded.borderWidth == 3);
+    CHECK(loaded.borderColor.g == 30);
+    CHECK(loaded.activeProfile == "b");
+    CHECK(loaded.hotkeys.size() == settings.hotkeys.size());
+    for (size_t i = 0; i < loaded.hotkeys.size() && i < settings.hotkeys.size(); ++i)
+    {
+        const Hotkey* original = findHotkey(settings, loaded.hotkeys[i].action);
+        CHECK(original != nullptr);
+        if (original)
+        {
+            CHECK(original->modifiers == loaded.hotkeys[i].modifiers);
+            CHECK(original->keyCode == loaded.hotkeys[i].keyCode);
+        }
+    }
+    CHECK(findHotkey(loaded, HotkeyAction::Cancel) == nullptr);
+
+    CHECK(loaded.profiles.size() == 2);
+    for (size_t i = 0; i < loaded.profiles.size() && i < settings.profiles.size(); ++i)
+    {
+        CHECK(loaded.profiles[i].name == settings.profiles[i].name);
+        CHECK(loaded.profiles[i].language == settings.profiles[i].language);
+        CHECK(loaded.profiles[i].pageSegMode == settings.profiles[i].pageSegMode);
+        CHECK(loaded.profiles[i].variables == settings.profiles[i].variables);
+        CHECK(loaded.profiles[i].preprocess == settings.profiles[i].preprocess);
+    }
+}
+
+void defaultsRoundTrip()
+{
+    Settings defaults = Settings::defaults();
+    std::string path = tempPath("defaults.ini");
+    defaults.save(path);
+    Settings loaded = Settings::load(path);
+    std::filesystem::remove(path);
+
+    CHECK(loaded.activeProfile == defaults.activeProfile);
+    CHECK(loaded.profiles.size() == defaults.profiles.size());
+    for (size_t i = 0; i < loaded.profiles.size() && i < defaults.profiles.size(); ++i)
+        CHECK(loaded.profiles[i].variables == defaults.profiles[i].variables);
+}
+
+void saveActiveProfileOnlyChangesThatLine()
+{
+    std::string path = tempPath("active.ini");
+    writeFile(path,
+        "; my settings\r\n"
+        "[general]\r\n"
+        "activeProfile = a\r\n"
+        "borderWidth=4\r\n"
+        "[profile:a]\r\n"
+        "[profile:b]\r\n");
+
+    Settings::saveActiveProfile(path, "b");
+    CHECK(readFile(path) ==
+        "; my settings\r\n"
+        "[general]\r\n"
+        "activeProfile=b\r\n"
+        "borderWidth=4\r\n"
+        "[profile:a]\r\n"
+        "[profile:b]\r\n");
+    CHECK(Settings::load(path).activeProfile == "b");
+
+    // Without the key it is added to [general]
+    writeFile(path, "[profile:a]\n[general]\nborderWidth=4\n");
+    Settings::saveActiveProfile(path, "a");
+    CHECK(readFile(path) == "[profile:a]\n[general]\nactiveProfile=a\nborderWidth=4\n");
+
+    // Without [general] the section is created
+    writeFile(path, "[profile:a]\n");
+    Settings::saveActiveProfile(path, "a");
+    CHECK(Settings::load(path).activeProfile == "a");
+
+    std::filesystem::remove(path);
+}
+
+void validateLanguagesReportsMissingModels()
+{
+    std::filesystem::path tessdata = std::filesystem::temp_directory_path() / "SettingsTests_tessdata";
+    std::filesystem::create_directories(tessdata);
+    writeFile((tessdata / "eng.traineddata").string(), "");
+
+    Settings settings = parseText("[profile:a]\n\n[profile:b]\npsm=3\nlanguage=eng+deu\n");
+    std::string error;
+    try {
+        settings.validateLanguages(tessdata.string());
+    }
+    catch (const std::runtime_error& e) {
+        error = e.what();
+    }
+    CHECK(contains(error, "line 5"));
+    CHECK(contains(error, "'deu'"));
+
+    bool defaultsValid = true;
+    try {
+        Settings::defaults().validateLanguages(tessdata.string());
+    }
+    catch (const std::runtime_error&) {
+        defaultsValid = false;
+    }
+    CHECK(defaultsValid);
+
+    std::filesystem::remove_all(tessdata);
+}
+
+int main()
+{
+    RUN_TEST(emptyFileGivesDefaults);
+    RUN_TEST(generalValuesAreParsed);
+    RUN_TEST(profilesAreCompiled);
+    RUN_TEST(missingActiveProfileUsesFirstProfile);
+    RUN_TEST(unknownActiveProfileIsRejected);
+    RUN_TEST(errorsReportTheLine);
+    RUN_TEST(hotkeysAreParsed);
+    RUN_TEST(globalHotkeysNeedAModifier);
+    RUN_TEST(duplicateHotkeysAreRejected);
+    RUN_TEST(saveAndLoadRoundTrip);
+    RUN_TEST(defaultsRoundTrip);
+    RUN_TEST(saveActiveProfileOnlyChangesThatLine);
+    RUN_TEST(validateLanguagesReportsMissingModels);
+    return TEST_EXIT_CODE();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal check macros, so the tests need nothing beyond the standard library.
+// A failed check is reported and the test keeps going.
+
+inline int& testFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                            \
+    do {                                                                            \
+        if (!(condition)) {                                                         \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++testFailures();                                                       \
+        }                                                                           \
+    } while (0)
+
+#define RUN_TEST(test)                      \
+    do {                                    \
+        int failuresBefore = testFailures(); \
+        test();                             \
+        std::printf("%s %s\n", testFailures() == failuresBefore ? "PASS" : "FAIL", #test); \
+    } while (0)
+
+#define TEST_EXIT_CODE() (testFailures() == 0 ? 0 : 1)
@@ -0,0 +1,134 @@
+// TextMetrics.cpp
+#include "TextMetrics.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+    // Levenshtein distance, keeping only two rows of the table
+    template <typename T>
+    size_t editDistance(const std::vector<T>& reference, const std::vector<T>& hypothesis)
+    {
+        std::vector<size_t> previous(hypothesis.size() + 1);
+        std::vector<size_t> current(hypothesis.size() + 1);
+        for (size_t j = 0; j <= hypothesis.size(); ++j)
+            previous[j] = j;
+
+        for (size_t i = 1; i <= reference.size(); ++i)
+        {
+            current[0] = i;
+            for (size_t j = 1; j <= hypothesis.size(); ++j)
+            {
+                size_t substitution = previous[j - 1] + (reference[i - 1] == hypothesis[j - 1] ? 0 : 1);
+                current[j] = std::min({ previous[j] + 1, current[j - 1] + 1, substitution });
+            }
+            std::swap(previous, current);
+        }
+        return previous[hypothesis.size()];
+    }
+
+    double errorRate(size_t edits, size_t referenceSize, size_t hypothesisSize)
+    {
+        // Against an empty reference any output is entirely wrong
+        if (referenceSize == 0)
+            return hypothesisSize == 0 ? 0.0 : 1.0;
+        return static_cast<double>(edits) / static_cast<double>(referenceSize);
+    }
+
+    bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+    }
+}
+
+std::string normalizeWhitespace(const std::string& text)
+{
+    std::string result;
+    bool pendingSpace = false;
+    for (char c : text)
+    {
+        if (isSpace(c))
+        {
+            pendingSpace = !result.empty();
+            continue;
+        }
+        if (pendingSpace)
+            result += ' ';
+        pendingSpace = false;
+        result += c;
+    }
+    return result;
+}
+
+std::vector<uint32_t> decodeUtf8(const std::string& text)
+{
+    const uint32_t Replacement = 0xFFFD;
+
+    std::vector<uint32_t> codePoints;
+    size_t i = 0;
+    while (i < text.size())
+    {
+        unsigned char lead = static_cast<unsigned char>(text[i]);
+        size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        if (length == 0 || i + length > text.size())
+        {
+            codePoints.push_back(Replacement);
+            ++i;
+            continue;
+        }
+
+        uint32_t codePoint = length == 1 ? lead : lead & (0x7F >> length);
+        bool valid = true;
+        for (size_t k = 1; k < length; ++k)
+        {
+            unsigned char next = static_cast<unsigned char>(text[i + k]);
+            if ((next & 0xC0) != 0x80)
+            {
+                valid = false;
+                break;
+            }
+            codePoint = (codePoint << 6) | (next & 0x3F);
+        }
+        if (!valid)
+        {
+            codePoints.push_back(Replacement);
+            ++i;
+            continue;
+        }
+
+        codePoints.push_back(codePoint);
+        i += length;
+    }
+    return codePoints;
+}
+
+std::vector<std::string> splitWords(const std::string& text)
+{
+    std::vector<std::string> words;
+    std::istringstream input(text);
+    std::string word;
+    while (input >> word)
+        words.push_back(word);
+    return words;
+}
+
+TextErrorRates compareText(const std::string& reference, const std::string& hypothesis)
+{
+    std::string normalizedReference = normalizeWhitespace(reference);
+    std::string normalizedHypothesis = normalizeWhitespace(hypothesis);
+
+    std::vector<uint32_t> referenceCharacters = decodeUtf8(normalizedReference);
+    std::vector<uint32_t> hypothesisCharacters = decodeUtf8(normalizedHypothesis);
+    std::vector<std::string> referenceWords = splitWords(normalizedReference);
+    std::vector<std::string> hypothesisWords = splitWords(normalizedHypothesis);
+
+    TextErrorRates rates;
+    rates.characterEdits = editDistance(referenceCharacters, hypothesisCharacters);
+    rates.referenceCharacters = referenceCharacters.size();
+    rates.wordEdits = editDistance(referenceWords, hypothesisWords);
+    rates.referenceWords = referenceWords.size();
+    rates.cer = errorRate(rates.characterEdits, referenceCharacters.size(), hypothesisCharacters.size());
+    rates.wer = errorRate(rates.wordEdits, referenceWords.size(), hypothesisWords.size());
+    return rates;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Error rates of recognized text against a golden reference. Both texts are
+// compared after collapsing whitespace (including line breaks) to single
+// spaces, since the layout of tesseract's output is not what is tested.
+struct TextErrorRates
+{
+    size_t characterEdits;      // Levenshtein distance over code points
+    size_t referenceCharacters;
+    size_t wordEdits;           // Levenshtein distance over words
+    size_t referenceWords;
+    double cer;                 // characterEdits / referenceCharacters
+    double wer;                 // wordEdits / referenceWords
+};
+
+std::string normalizeWhitespace(const std::string& text);
+// Code points of UTF-8 text, invalid bytes become U+FFFD
+std::vector<uint32_t> decodeUtf8(const std::string& text);
+std::vector<std::string> splitWords(const std::string& text);
+
+TextErrorRates compareText(const std::string& reference, const std::string& hypothesis);
@@ -0,0 +1,87 @@
+// TextMetricsTests.cpp
+#include "TextMetrics.h"
+#include "TestCheck.h"
+
+#include <cmath>
+
+namespace
+{
+    bool near(double value, double expected)
+    {
+        return std::fabs(value - expected) < 1e-9;
+    }
+}
+
+void whitespaceIsCollapsed()
+{
+    CHECK(normalizeWhitespace("  a \t b\r\n\n c  \n") == "a b c");
+    CHECK(normalizeWhitespace("") == "");
+    CHECK(normalizeWhitespace(" \n ") == "");
+}
+
+void utf8IsDecodedToCodePoints()
+{
+    std::vector<uint32_t> codePoints = decodeUtf8("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+    CHECK(codePoints.size() == 4);
+    CHECK(codePoints.size() == 4 && codePoints[1] == 0xE9 && codePoints[2] == 0x20AC && codePoints[3] == 0x1F600);
+
+    // A stray continuation byte and a truncated sequence become U+FFFD
+    std::vector<uint32_t> invalid = decodeUtf8("\x80x\xE2\x82");
+    CHECK(invalid.size() == 4);
+    CHECK(invalid.size() == 4 && invalid[0] == 0xFFFD && invalid[1] == 'x');
+}
+
+void identicalTextHasNoErrors()
+{
+    TextErrorRates rates = compareText("int x = 1;\nreturn x;\n", "int x = 1;  return x;");
+    CHECK(rates.characterEdits == 0);
+    CHECK(rates.wordEdits == 0);
+    CHECK(near(rates.cer, 0.0));
+    CHECK(near(rates.wer, 0.0));
+}
+
+void characterErrorsUseEditDistance()
+{
+    // One substitution, one deletion and one insertion
+    TextErrorRates rates = compareText("kitten", "sittin");
+    CHECK(rates.characterEdits == 2);
+    CHECK(rates.referenceCharacters == 6);
+    CHECK(near(rates.cer, 2.0 / 6.0));
+
+    CHECK(compareText("abc", "abxc").characterEdits == 1);
+    CHECK(compareText("abc", "ac").characterEdits == 1);
+    CHECK(compareText("abc", "").characterEdits == 3);
+
+    // A multi-byte character counts once
+    CHECK(compareText("caf\xC3\xA9", "cafe").characterEdits == 1);
+}
+
+void wordErrorsUseEditDistance()
+{
+    TextErrorRates rates = compareText("the quick brown fox", "the quack brown fox jumps");
+    CHECK(rates.wordEdits == 2);
+    CHECK(rates.referenceWords == 4);
+    CHECK(near(rates.wer, 0.5));
+
+    // Rates can exceed 1 when the output is much longer than the reference
+    CHECK(compareText("a", "b c d").wer > 1.0);
+}
+
+void emptyReference()
+{
+    CHECK(near(compareText("", "").cer, 0.0));
+    CHECK(near(compareText(" \n", "").wer, 0.0));
+    CHECK(near(compareText("", "noise").cer, 1.0));
+    CHECK(near(compareText("", "noise").wer, 1.0));
+}
+
+int main()
+{
+    RUN_TEST(whitespaceIsCollapsed);
+    RUN_TEST(utf8IsDecodedToCodePoints);
+    RUN_TEST(identicalTextHasNoErrors);
+    RUN_TEST(characterErrorsUseEditDistance);
+    RUN_TEST(wordErrorsUseEditDistance);
+    RUN_TEST(emptyReference);
+    return TEST_EXIT_CODE();
+}
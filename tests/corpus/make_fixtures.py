@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+# Renders the v1 corpus: one PNG per fixture plus its golden .txt.
+#
+#   python3 make_fixtures.py
+#
+# Needs Pillow and the DejaVu fonts. Published corpus versions must never
+# change; to change a fixture, add a new version directory instead.
+
+import os
+from PIL import Image, ImageDraw, ImageFont
+
+FONT_DIR = "/usr/share/fonts/truetype/dejavu"
+OUT_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "v1")
+
+LIGHT = ((255, 255, 255), (0, 0, 0))
+DARK = ((30, 30, 30), (212, 212, 212))
+
+# name, font, size, (background, foreground), lines
+FIXTURES = [
+    ("code_cpp_light", "DejaVuSansMono.ttf", 16, LIGHT, [
+        "for (int i = 0; i < count; ++i) {",
+        "    total += values[i] * 2;",
+        "}",
+        "return total;",
+    ]),
+    ("code_shell_dark", "DejaVuSansMono.ttf", 16, DARK, [
+        "git log --oneline -n 5 | grep fix",
+        "export PATH=$HOME/bin:$PATH",
+        "make -j8 && ./run_tests --verbose",
+    ]),
+    ("code_json_light", "DejaVuSansMono.ttf", 15, LIGHT, [
+        "{",
+        "  \"name\": \"ScreenCapture\",",
+        "  \"version\": 2,",
+        "  \"tags\": [\"ocr\", \"win32\"]",
+        "}",
+    ]),
+    ("numbers_prices", "DejaVuSans.ttf", 16, LIGHT, [
+        "1,234.56   -78.90   +12.5",
+        "2024   365   0.001   -7",
+    ]),
+    ("numbers_small", "DejaVuSans.ttf", 13, LIGHT, [
+        "3.14159   2.71828   1.41421",
+        "100,000   -0.5   +42",
+    ]),
+    ("prose_paragraph", "DejaVuSans.ttf", 16, LIGHT, [
+        "The quick brown fox jumps over the lazy dog.",
+        "Screen text is copied to the clipboard after",
+        "the selected region has been recognized.",
+    ]),
+    ("prose_dialog", "DejaVuSans.ttf", 14, LIGHT, [
+        "Save changes to the document before closing?",
+        "Unsaved changes will be lost.",
+    ]),
+    ("prose_serif_dark", "DejaVuSerif.ttf", 16, DARK, [
+        "Watch mode captures the same region again",
+        "every two seconds and updates the clipboard",
+        "only when the recognized text has changed.",
+    ]),
+]
+
+PADDING = 12
+LINE_SPACING = 1.5
+
+
+def render(name, font_file, size, colors, lines):
+    background, foreground = colors
+    font = ImageFont.truetype(os.path.join(FONT_DIR, font_file), size)
+    line_height = int(size * LINE_SPACING)
+    width = max(int(font.getlength(line)) for line in lines) + 2 * PADDING
+    height = line_height * len(lines) + 2 * PADDING
+
+    image = Image.new("RGB", (width, height), background)
+    draw = ImageDraw.Draw(image)
+    for index, line in enumerate(lines):
+        draw.text((PADDING, PADDING + index * line_height), line, font=font, fill=foreground)
+    image.save(os.path.join(OUT_DIR, name + ".png"), optimize=True)
+
+    with open(os.path.join(OUT_DIR, name + ".txt"), "w", newline="\n") as golden:
+        golden.write("\n".join(lines) + "\n")
+
+
+def main():
+    os.makedirs(OUT_DIR, exist_ok=True)
+    for fixture in FIXTURES:
+        render(*fixture)
+
+
+if __name__ == "__main__":
+    main()